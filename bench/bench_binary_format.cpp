@@ -0,0 +1,50 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include "binary_format.h"
+#include "club_runner.h"
+#include "workload.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+  workload::Spec spec;
+  spec.num_events = 1000000;
+  std::string text = workload::generate(spec);
+
+  std::istringstream text_for_convert(text);
+  std::ostringstream binary_out;
+  binary_format::convertTextToBinary(text_for_convert, binary_out);
+  std::string binary = binary_out.str();
+
+  std::ostringstream text_report, binary_report;
+  double text_ms = measureMs([&] {
+    std::istringstream in(text);
+    runTextInput(in, text_report);
+  });
+  double binary_ms = measureMs([&] {
+    std::istringstream in(binary);
+    runBinaryInput(in, binary_report, std::cerr);
+  });
+
+  std::cout << "events:        " << spec.num_events << '\n'
+            << "text size:     " << text.size() << " bytes\n"
+            << "binary size:   " << binary.size() << " bytes ("
+            << static_cast<double>(text.size()) / binary.size() << "x)\n"
+            << "text run:      " << text_ms << " ms\n"
+            << "binary run:    " << binary_ms << " ms\n"
+            << "same output:   "
+            << (text_report.str() == binary_report.str() ? "yes" : "NO")
+            << '\n';
+  return 0;
+}
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include "club_replay.h"
+#include "club_runner.h"
+#include "workload.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+  workload::Spec spec;
+  spec.num_tables = 32;
+  spec.num_clients = 256;
+  spec.num_events = 1000000;
+  std::istringstream input(workload::generate(spec));
+
+  ReplayIndex index;
+  double build_ms = measureMs([&] { index.build(input); });
+  std::size_t index_size = index.serialize().size();
+
+  // full replay is what a query costs without the index
+  double full_ms = measureMs([&] {
+    input.clear();
+    input.seekg(0);
+    std::ostringstream report;
+    runTextInput(input, report);
+  });
+
+  const Time times[] = {Time(9, 0), Time(14, 37), Time(22, 30)};
+  double query_ms = 0;
+  for (const Time &time : times) {
+    ClubStateSnapshot state;
+    query_ms += measureMs([&] { index.stateAt(input, time, state); });
+  }
+
+  std::cout << "events:            " << spec.num_events << '\n'
+            << "checkpoints:       " << index.getCheckpoints().size() << '\n'
+            << "index size:        " << index_size << " bytes\n"
+            << "index build:       " << build_ms << " ms\n"
+            << "full replay:       " << full_ms << " ms\n"
+            << "query (avg of 3):  " << query_ms / 3 << " ms\n";
+  return 0;
+}
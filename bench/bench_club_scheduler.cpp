@@ -0,0 +1,100 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "club_runner.h"
+#include "club_scheduler.h"
+#include "workload.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+std::vector<std::string> splitLines(const std::string &text) {
+  std::vector<std::string> lines;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+} // namespace
+
+int main() {
+  const int num_clubs = 2000;
+  const std::size_t events_per_club = 500;
+
+  std::vector<std::string> inputs;
+  std::vector<std::vector<std::string>> lines;
+  std::size_t total_lines = 0;
+  for (int i = 0; i < num_clubs; ++i) {
+    workload::Spec spec;
+    spec.num_tables = 4 + i % 20;
+    spec.num_clients = 40;
+    spec.num_events = events_per_club;
+    spec.seed = i;
+    inputs.push_back(workload::generate(spec));
+    lines.push_back(splitLines(inputs.back()));
+    total_lines += lines.back().size();
+  }
+
+  // baseline: each club processed alone, one after another
+  std::vector<std::ostringstream> direct_outputs(num_clubs);
+  double direct_ms = measureMs([&] {
+    for (int i = 0; i < num_clubs; ++i) {
+      std::istringstream in(inputs[i]);
+      runTextInput(in, direct_outputs[i]);
+    }
+  });
+
+  // all clubs interleaved on one thread, lines arriving round-robin
+  ClubScheduler scheduler;
+  std::vector<std::unique_ptr<MemoryLineSource>> sources;
+  std::vector<std::ostringstream> outputs(num_clubs);
+  double scheduled_ms = measureMs([&] {
+    for (int i = 0; i < num_clubs; ++i) {
+      sources.push_back(std::make_unique<MemoryLineSource>(16));
+      scheduler.spawn(runClubStream(scheduler, *sources[i], outputs[i]));
+    }
+    std::vector<std::size_t> next(num_clubs, 0);
+    bool fed_any = true;
+    while (fed_any) {
+      fed_any = false;
+      for (int i = 0; i < num_clubs; ++i) {
+        while (next[i] < lines[i].size() &&
+               sources[i]->push(lines[i][next[i]])) {
+          ++next[i];
+          fed_any = true;
+        }
+        if (next[i] == lines[i].size()) {
+          sources[i]->close();
+        }
+      }
+      scheduler.run();
+    }
+  });
+
+  bool same = true;
+  for (int i = 0; i < num_clubs; ++i) {
+    same = same && outputs[i].str() == direct_outputs[i].str();
+  }
+
+  double overhead_ns = (scheduled_ms - direct_ms) * 1e6 / total_lines;
+  std::cout << "clubs:               " << num_clubs << '\n'
+            << "lines:               " << total_lines << '\n'
+            << "sequential:          " << direct_ms << " ms\n"
+            << "coroutine scheduler: " << scheduled_ms << " ms ("
+            << scheduler.resumeCount() << " resumes)\n"
+            << "overhead per line:   " << overhead_ns << " ns\n"
+            << "same output:         " << (same ? "yes" : "NO") << '\n';
+  return 0;
+}
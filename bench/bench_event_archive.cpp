@@ -0,0 +1,77 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include "club_runner.h"
+#include "event_archive.h"
+#include "workload.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// the straightforward way to load a stored text log back into events
+std::vector<Event> parseTextLog(const std::string &text) {
+  std::vector<Event> events;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string time, name;
+    int id = 0, table_id = 0;
+    fields >> time >> id >> name >> table_id;
+    if (id == 13) {
+      events.push_back(Event::newErrorEvent(Time::parse(time), name));
+    } else {
+      events.push_back(
+          Event::newClientTableEvent(Time::parse(time), id, name, table_id));
+    }
+  }
+  return events;
+}
+
+} // namespace
+
+int main() {
+  workload::Spec spec;
+  spec.num_events = 1000000;
+  std::istringstream input(workload::generate(spec));
+  std::ostringstream archive_out;
+  if (event_archive::archiveDayLog(input, archive_out).has_value()) {
+    std::cerr << "Error: workload stops early" << std::endl;
+    return 1;
+  }
+  std::string archive = archive_out.str();
+
+  std::istringstream archive_in(archive);
+  std::ostringstream text_out;
+  event_archive::decompressToText(archive_in, text_out);
+  std::string text = text_out.str();
+
+  std::vector<Event> from_text, from_archive;
+  double text_ms = measureMs([&] { from_text = parseTextLog(text); });
+  double archive_ms = measureMs([&] {
+    event_archive::Reader reader;
+    reader.open(archive);
+    reader.readAll(from_archive);
+  });
+
+  bool same = from_text.size() == from_archive.size();
+  for (std::size_t i = 0; same && i < from_text.size(); ++i) {
+    same = from_text[i].toString() == from_archive[i].toString();
+  }
+
+  std::cout << "log lines:     " << from_archive.size() << '\n'
+            << "text size:     " << text.size() << " bytes\n"
+            << "archive size:  " << archive.size() << " bytes ("
+            << static_cast<double>(text.size()) / archive.size() << "x)\n"
+            << "text load:     " << text_ms << " ms\n"
+            << "archive load:  " << archive_ms << " ms\n"
+            << "same events:   " << (same ? "yes" : "NO") << '\n';
+  return 0;
+}
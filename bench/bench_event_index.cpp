@@ -0,0 +1,66 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "event_index.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+  // synthetic log shaped like a busy day, no engine needed
+  const std::uint32_t num_events = 20000000;
+  const int num_clients = 200000;
+  const int num_tables = 500;
+  std::vector<Event> log;
+  log.reserve(num_events);
+  std::uint64_t state = 42;
+  for (std::uint32_t i = 0; i < num_events; ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    int minute = static_cast<int>(
+        static_cast<std::uint64_t>(i) * (24 * 60) / num_events);
+    std::string name = "client" + std::to_string((state >> 33) % num_clients);
+    int table_id = static_cast<int>((state >> 13) % num_tables) + 1;
+    log.push_back(
+        Event::newClientTableEvent(Time(minute), 2, std::move(name), table_id));
+  }
+
+  EventLogIndex index;
+  double build_ms = measureMs([&] { index.catchUp(log); });
+
+  std::size_t indexed_hits = 0, scanned_hits = 0;
+  double index_ms = measureMs([&] {
+    indexed_hits += index.clientEvents("client777").size();
+    indexed_hits += index.tableEvents(7).size();
+    indexed_hits += index.timeRange(Time(14, 37), Time(14, 37)).size();
+  });
+  double scan_ms = measureMs([&] {
+    for (const Event &event : log) {
+      scanned_hits += event.client_name == "client777";
+      scanned_hits += event.table_id_val == 7;
+      scanned_hits += event.event_time == Time(14, 37);
+    }
+  });
+
+  std::string data;
+  double serialize_ms = measureMs([&] { data = index.serialize(); });
+
+  std::cout << "events:          " << num_events << '\n'
+            << "index build:     " << build_ms << " ms\n"
+            << "index size:      " << data.size() << " bytes\n"
+            << "serialize:       " << serialize_ms << " ms\n"
+            << "3 lookups index: " << index_ms << " ms\n"
+            << "3 lookups scan:  " << scan_ms << " ms\n"
+            << "same hits:       "
+            << (indexed_hits == scanned_hits ? "yes" : "NO") << '\n';
+  return 0;
+}
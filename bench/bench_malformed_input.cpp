@@ -0,0 +1,136 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "club_runner.h"
+#include "computer_club.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// integer validation as it was before the switch to std::from_chars
+bool legacyIsValidIntegerString(const std::string &s, int &out_val,
+                                int min_val, int max_val) {
+  if (s.empty())
+    return false;
+  for (char c : s) {
+    if (!std::isdigit(c))
+      return false;
+  }
+  try {
+    if (s.length() > 1 && s[0] == '0')
+      return false;
+    long long val = std::stoll(s);
+    if (val < min_val || val > max_val) {
+      return false;
+    }
+    out_val = static_cast<int>(val);
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+std::vector<std::string> makeTimeTokens(std::size_t count) {
+  const char *bad[] = {"25:61", "ab:cd", "99:99", "1x:00", "24:00", "00:60"};
+  std::mt19937 rng(7);
+  std::vector<std::string> tokens;
+  tokens.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (rng() % 10 < 8) {
+      tokens.push_back(bad[rng() % 6]);
+    } else {
+      tokens.push_back(Time(static_cast<int>(rng() % 1440)).toString());
+    }
+  }
+  return tokens;
+}
+
+std::vector<std::string> makeIntegerTokens(std::size_t count) {
+  std::mt19937 rng(11);
+  std::vector<std::string> tokens;
+  tokens.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (rng() % 10 < 8) {
+      tokens.push_back("99999999999999999999" + std::to_string(rng() % 10));
+    } else {
+      tokens.push_back(std::to_string(rng() % 1000 + 1));
+    }
+  }
+  return tokens;
+}
+
+} // namespace
+
+int main() {
+  const std::size_t count = 1000000;
+  std::vector<std::string> times = makeTimeTokens(count);
+  std::vector<std::string> integers = makeIntegerTokens(count);
+
+  std::size_t accepted_legacy = 0, accepted_new = 0;
+  double time_legacy_ms = measureMs([&] {
+    for (const auto &token : times) {
+      try {
+        Time::parse(token);
+        ++accepted_legacy;
+      } catch (const std::runtime_error &) {
+      }
+    }
+  });
+  double time_new_ms = measureMs([&] {
+    Time parsed;
+    for (const auto &token : times) {
+      if (Time::tryParse(token, parsed) == TimeParseStatus::OK) {
+        ++accepted_new;
+      }
+    }
+  });
+
+  std::size_t int_legacy = 0, int_new = 0;
+  double int_legacy_ms = measureMs([&] {
+    int value;
+    for (const auto &token : integers) {
+      int_legacy += legacyIsValidIntegerString(token, value, 1, 1 << 30);
+    }
+  });
+  double int_new_ms = measureMs([&] {
+    int value;
+    for (const auto &token : integers) {
+      int_new += utils::isValidIntegerString(token, value, 1, 1 << 30);
+    }
+  });
+
+  // dirty feed: many short inputs, each ending on a malformed line
+  const std::size_t num_inputs = 100000;
+  std::ostringstream sink;
+  double feed_ms = measureMs([&] {
+    for (std::size_t i = 0; i < num_inputs; ++i) {
+      std::istringstream input("3\n09:00 19:00\n10\n09:05 1 client1\n"
+                               "9x:15 2 client1 1\n");
+      runTextInput(input, sink);
+    }
+  });
+
+  std::cout << "time tokens (80% malformed): " << count << '\n'
+            << "  throwing parse:   " << time_legacy_ms << " ms\n"
+            << "  tryParse:         " << time_new_ms << " ms\n"
+            << "  same verdicts:    "
+            << (accepted_legacy == accepted_new ? "yes" : "NO") << '\n'
+            << "integer tokens (80% overflow): " << count << '\n'
+            << "  stoll + catch:    " << int_legacy_ms << " ms\n"
+            << "  from_chars:       " << int_new_ms << " ms\n"
+            << "  same verdicts:    " << (int_legacy == int_new ? "yes" : "NO")
+            << '\n'
+            << "malformed inputs:   " << num_inputs << " in " << feed_ms
+            << " ms\n";
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "computer_club.h"
+#include "workload.h"
+
+namespace {
+
+template <typename Fn> double measureMs(Fn &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+  const int num_tables = 100000;
+  const int repeats = 200;
+
+  // array of TableInfo, the layout used before TableSet
+  std::vector<TableInfo> aos_tables;
+  aos_tables.reserve(num_tables);
+  TableSet<kDynamicTables> soa_tables;
+  soa_tables.reset(num_tables);
+  for (int id = 1; id <= num_tables; ++id) {
+    aos_tables.emplace_back(id);
+    if (id != num_tables) {
+      aos_tables.back().occupy("client" + std::to_string(id), Time(9, 0));
+      soa_tables.occupy(id, static_cast<std::uint32_t>(id), Time(9, 0));
+    }
+  }
+
+  long long checksum_aos = 0, checksum_soa = 0;
+  double scan_aos_ms = measureMs([&] {
+    for (int r = 0; r < repeats; ++r) {
+      for (const auto &table : aos_tables) {
+        if (!table.is_occupied) {
+          checksum_aos += table.id;
+          break;
+        }
+      }
+    }
+  });
+  double scan_soa_ms = measureMs([&] {
+    for (int r = 0; r < repeats; ++r) {
+      checksum_soa += soa_tables.findFree();
+    }
+  });
+
+  for (int id = 1; id < num_tables; ++id) {
+    aos_tables[id - 1].free(Time(10, id % 60), 10);
+    soa_tables.free(id, Time(10, id % 60), 10);
+  }
+  long long totals_aos = 0, totals_soa = 0;
+  double totals_aos_ms = measureMs([&] {
+    for (int r = 0; r < repeats; ++r) {
+      for (const auto &table : aos_tables) {
+        totals_aos += table.total_minutes_used + table.revenue_generated;
+      }
+    }
+  });
+  double totals_soa_ms = measureMs([&] {
+    for (int r = 0; r < repeats; ++r) {
+      for (int id = 1; id <= num_tables; ++id) {
+        totals_soa +=
+            soa_tables.minutesUsed(id) + soa_tables.revenueGenerated(id);
+      }
+    }
+  });
+
+  // whole engine on a table-heavy day
+  workload::Spec spec;
+  spec.num_tables = 20000;
+  spec.num_clients = 50000;
+  spec.num_events = 500000;
+  std::istringstream input(workload::generate(spec));
+  ComputerClub club;
+  club.loadConfiguration(input);
+  std::string line;
+  double events_ms = measureMs([&] {
+    while (std::getline(input, line)) {
+      club.processEventLine(line);
+    }
+    club.processEndOfDay();
+  });
+  std::size_t stats_lines = 0;
+  double stats_ms =
+      measureMs([&] { stats_lines = club.getTableStatistics().size(); });
+
+  std::cout << "tables:                 " << num_tables << '\n'
+            << "free-table search x" << repeats << '\n'
+            << "  TableInfo array:      " << scan_aos_ms << " ms\n"
+            << "  TableSet bitmap:      " << scan_soa_ms << " ms\n"
+            << "  same result:          "
+            << (checksum_aos == checksum_soa ? "yes" : "NO") << '\n'
+            << "totals pass x" << repeats << '\n'
+            << "  TableInfo array:      " << totals_aos_ms << " ms\n"
+            << "  TableSet columns:     " << totals_soa_ms << " ms\n"
+            << "  same result:          "
+            << (totals_aos == totals_soa ? "yes" : "NO") << '\n'
+            << "engine, " << spec.num_tables << " tables, " << spec.num_events
+            << " events: " << events_ms << " ms\n"
+            << "end-of-day statistics:  " << stats_lines << " lines in "
+            << stats_ms << " ms\n";
+  return 0;
+}
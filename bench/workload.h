@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+#include "computer_club.h"
+
+// Synthetic, syntactically valid input files for benchmarks and tests.
+namespace workload {
+
+struct Spec {
+  int num_tables = 16;
+  int num_clients = 64;
+  std::size_t num_events = 100000;
+  unsigned seed = 42;
+};
+
+inline std::string generate(const Spec &spec) {
+  std::mt19937 rng(spec.seed);
+  std::uniform_int_distribution<int> client_dist(1, spec.num_clients);
+  std::uniform_int_distribution<int> table_dist(1, spec.num_tables);
+  std::uniform_int_distribution<int> kind_dist(0, 99);
+
+  const Time open_time(8, 0);
+  const Time close_time(23, 0);
+  const int day_minutes = open_time.minutesUntil(close_time);
+
+  std::string text = std::to_string(spec.num_tables) + "\n" +
+                     open_time.toString() + " " + close_time.toString() +
+                     "\n10\n";
+  text.reserve(text.size() + spec.num_events * 24);
+
+  for (std::size_t i = 0; i < spec.num_events; ++i) {
+    Time t = open_time.addMinutes(static_cast<int>(
+        static_cast<unsigned long long>(i) * day_minutes / spec.num_events));
+    int kind = kind_dist(rng);
+    int event_id = kind < 30 ? 1 : kind < 60 ? 2 : kind < 75 ? 3 : 4;
+
+    text += t.toString();
+    text += ' ';
+    text += std::to_string(event_id);
+    text += " client";
+    text += std::to_string(client_dist(rng));
+    if (event_id == 2) {
+      text += ' ';
+      text += std::to_string(table_dist(rng));
+    }
+    text += '\n';
+  }
+  return text;
+}
+
+} // namespace workload
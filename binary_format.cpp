@@ -0,0 +1,324 @@
+#include "binary_format.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+
+namespace binary_format {
+namespace {
+
+std::string readWholeStream(std::istream &input) {
+  return std::string(std::istreambuf_iterator<char>(input),
+                     std::istreambuf_iterator<char>());
+}
+
+// magic, version and club configuration; cursor ends after the header
+std::optional<std::string> readHeader(const std::uint8_t *&cursor,
+                                      const std::uint8_t *end,
+                                      ClubConfig &config) {
+  if (end - cursor < static_cast<std::ptrdiff_t>(sizeof(kMagic) + 1) ||
+      std::memcmp(cursor, kMagic, sizeof(kMagic)) != 0) {
+    return "not a binary event file";
+  }
+  cursor += sizeof(kMagic);
+  if (*cursor++ != kVersion) {
+    return "unsupported binary format version";
+  }
+
+  std::uint64_t num_tables, open_minutes, close_minutes, hourly_rate;
+  if (!readVarint(cursor, end, num_tables) ||
+      !readVarint(cursor, end, open_minutes) ||
+      !readVarint(cursor, end, close_minutes) ||
+      !readVarint(cursor, end, hourly_rate)) {
+    return "truncated header";
+  }
+  constexpr std::uint64_t max_int = std::numeric_limits<int>::max();
+  if (num_tables == 0 || num_tables > max_int || hourly_rate == 0 ||
+      hourly_rate > max_int || open_minutes >= close_minutes ||
+      close_minutes >= 24 * 60) {
+    return "invalid configuration in header";
+  }
+  config.num_tables = static_cast<int>(num_tables);
+  config.open_time = Time(static_cast<int>(open_minutes));
+  config.close_time = Time(static_cast<int>(close_minutes));
+  config.hourly_rate = static_cast<int>(hourly_rate);
+  return std::nullopt;
+}
+
+} // namespace
+
+void writeVarint(std::string &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool readVarint(const std::uint8_t *&cursor, const std::uint8_t *end,
+                std::uint64_t &out) {
+  out = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (cursor == end) {
+      return false;
+    }
+    std::uint8_t byte = *cursor++;
+    out |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void writeBytes(std::string &out, const std::string &bytes) {
+  writeVarint(out, bytes.size());
+  out += bytes;
+}
+
+bool readBytes(const std::uint8_t *&cursor, const std::uint8_t *end,
+               std::string &out) {
+  std::uint64_t length;
+  if (!readVarint(cursor, end, length) ||
+      length > static_cast<std::uint64_t>(end - cursor)) {
+    return false;
+  }
+  out.assign(reinterpret_cast<const char *>(cursor), length);
+  cursor += length;
+  return true;
+}
+
+// --- class Reader ---
+bool Reader::readVarint(std::uint64_t &out) {
+  return binary_format::readVarint(cursor, end, out);
+}
+
+std::optional<std::string> Reader::open(const std::string &data) {
+  cursor = reinterpret_cast<const std::uint8_t *>(data.data());
+  end = cursor + data.size();
+  dictionary.clear();
+  last_minutes = 0;
+
+  std::optional<std::string> header_error = readHeader(cursor, end, config);
+  if (header_error.has_value()) {
+    return header_error;
+  }
+
+  std::uint64_t dictionary_size;
+  if (!readVarint(dictionary_size) ||
+      dictionary_size > static_cast<std::uint64_t>(end - cursor)) {
+    return "truncated dictionary";
+  }
+  dictionary.reserve(dictionary_size);
+  for (std::uint64_t i = 0; i < dictionary_size; ++i) {
+    std::uint64_t length;
+    if (!readVarint(length) ||
+        length > static_cast<std::uint64_t>(end - cursor)) {
+      return "truncated dictionary";
+    }
+    std::string name(reinterpret_cast<const char *>(cursor), length);
+    cursor += length;
+    if (!utils::isValidClientName(name)) {
+      return "invalid client name in dictionary";
+    }
+    dictionary.push_back(std::move(name));
+  }
+
+  if (!readVarint(records_left)) {
+    return "truncated record count";
+  }
+  return std::nullopt;
+}
+
+const ClubConfig &Reader::getConfiguration() const { return config; }
+
+const std::vector<std::string> &Reader::getDictionary() const {
+  return dictionary;
+}
+
+bool Reader::next(Record &record, std::optional<std::string> &error) {
+  if (records_left == 0) {
+    return false;
+  }
+  --records_left;
+  if (cursor == end) {
+    error = "truncated record";
+    return false;
+  }
+
+  record.kind = *cursor++;
+  if (record.kind == kRawLineRecord) {
+    std::uint64_t length;
+    if (!readVarint(length) ||
+        length > static_cast<std::uint64_t>(end - cursor)) {
+      error = "truncated raw line record";
+      return false;
+    }
+    record.raw_line.assign(reinterpret_cast<const char *>(cursor), length);
+    cursor += length;
+    return true;
+  }
+  if (record.kind > 4) {
+    error = "unknown record kind";
+    return false;
+  }
+
+  std::uint64_t delta, client_index;
+  if (!readVarint(delta) || !readVarint(client_index)) {
+    error = "truncated event record";
+    return false;
+  }
+  if (delta >= 24 * 60 || last_minutes + static_cast<int>(delta) >= 24 * 60) {
+    error = "event time out of range";
+    return false;
+  }
+  if (client_index >= dictionary.size()) {
+    error = "client index out of range";
+    return false;
+  }
+  last_minutes += static_cast<int>(delta);
+  record.time = Time(last_minutes);
+  record.client_index = static_cast<std::uint32_t>(client_index);
+  record.table_id = 0;
+
+  if (record.kind == 2) {
+    std::uint64_t table_id;
+    if (!readVarint(table_id)) {
+      error = "truncated event record";
+      return false;
+    }
+    if (table_id == 0 ||
+        table_id > static_cast<std::uint64_t>(config.num_tables)) {
+      error = "table id out of range";
+      return false;
+    }
+    record.table_id = static_cast<int>(table_id);
+  }
+  return true;
+}
+
+bool isBinaryEventFile(const std::string &path) {
+  // reading the header of a pipe, FIFO or /dev/stdin would consume it
+  // before the real read, so only regular files are sniffed
+  std::error_code error;
+  if (!std::filesystem::is_regular_file(path, error)) {
+    return false;
+  }
+  // magic, version and four varints of at most 10 bytes each
+  char header[sizeof(kMagic) + 1 + 4 * 10];
+  std::ifstream file(path, std::ios::binary);
+  file.read(header, sizeof(header));
+  // a text file may start with the magic too, the header must validate
+  const auto *cursor = reinterpret_cast<const std::uint8_t *>(header);
+  ClubConfig config;
+  return !readHeader(cursor, cursor + file.gcount(), config).has_value();
+}
+
+std::optional<std::string> convertTextToBinary(std::istream &text_input,
+                                               std::ostream &binary_output) {
+  ClubConfig config;
+  std::optional<std::string> config_error =
+      loadClubConfiguration(text_input, config);
+  if (config_error.has_value()) {
+    return "invalid configuration line: " + config_error.value();
+  }
+
+  std::unordered_map<std::string, std::uint32_t> name_to_index;
+  std::vector<const std::string *> names;
+  std::string records;
+  std::uint64_t record_count = 0;
+  int last_minutes = 0;
+
+  std::string line;
+  while (std::getline(text_input, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    ++record_count;
+
+    // same acceptance rules as task: the first rejected line ends the input
+    std::optional<EventInput> event = parseEventInput(line, config.num_tables);
+    if (!event.has_value() || event->time.toMinutes() < last_minutes) {
+      records.push_back(static_cast<char>(kRawLineRecord));
+      writeBytes(records, line);
+      break;
+    }
+
+    auto [it, inserted] = name_to_index.try_emplace(
+        event->client_name, static_cast<std::uint32_t>(names.size()));
+    if (inserted) {
+      names.push_back(&it->first);
+    }
+
+    records.push_back(static_cast<char>(event->id));
+    writeVarint(records, event->time.toMinutes() - last_minutes);
+    writeVarint(records, it->second);
+    if (event->id == 2) {
+      writeVarint(records, event->table_id);
+    }
+    last_minutes = event->time.toMinutes();
+  }
+
+  std::string header(kMagic, sizeof(kMagic));
+  header.push_back(static_cast<char>(kVersion));
+  writeVarint(header, config.num_tables);
+  writeVarint(header, config.open_time.toMinutes());
+  writeVarint(header, config.close_time.toMinutes());
+  writeVarint(header, config.hourly_rate);
+  writeVarint(header, names.size());
+  for (const std::string *name : names) {
+    writeBytes(header, *name);
+  }
+  writeVarint(header, record_count);
+
+  binary_output.write(header.data(), header.size());
+  binary_output.write(records.data(), records.size());
+  if (!binary_output) {
+    return "write error";
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> convertBinaryToText(std::istream &binary_input,
+                                               std::ostream &text_output) {
+  std::string data = readWholeStream(binary_input);
+  Reader reader;
+  std::optional<std::string> error = reader.open(data);
+  if (error.has_value()) {
+    return error;
+  }
+
+  const ClubConfig &config = reader.getConfiguration();
+  text_output << config.num_tables << '\n'
+              << config.open_time.toString() << ' '
+              << config.close_time.toString() << '\n'
+              << config.hourly_rate << '\n';
+
+  const std::vector<std::string> &names = reader.getDictionary();
+  Record record;
+  while (reader.next(record, error)) {
+    if (record.kind == kRawLineRecord) {
+      text_output << record.raw_line << '\n';
+      continue;
+    }
+    text_output << record.time.toString() << ' '
+                << static_cast<int>(record.kind) << ' '
+                << names[record.client_index];
+    if (record.kind == 2) {
+      text_output << ' ' << record.table_id;
+    }
+    text_output << '\n';
+  }
+  if (error.has_value()) {
+    return error;
+  }
+  if (!text_output) {
+    return "write error";
+  }
+  return std::nullopt;
+}
+
+} // namespace binary_format
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "computer_club.h"
+
+// Compact binary representation of an input file.
+//
+// Layout (version 1, all integers are LEB128 varints unless noted):
+//   "CCEB" magic, u8 version
+//   num_tables, open minutes, close minutes, hourly rate
+//   dictionary: count, then for each name: length + bytes
+//   record count, then records:
+//     u8 kind (1-4 = event id), time delta from previous record,
+//     client index, and table id for kind 2
+//     u8 kind 0 = raw text line that `task` rejects (printed as-is)
+namespace binary_format {
+
+constexpr char kMagic[4] = {'C', 'C', 'E', 'B'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::uint8_t kRawLineRecord = 0;
+
+struct Record {
+  std::uint8_t kind = 0;
+  Time time;
+  std::uint32_t client_index = 0;
+  int table_id = 0;
+  std::string raw_line;
+};
+
+// --- decoder over an in-memory file image ---
+class Reader {
+private:
+  const std::uint8_t *cursor = nullptr;
+  const std::uint8_t *end = nullptr;
+  ClubConfig config;
+  std::vector<std::string> dictionary;
+  std::uint64_t records_left = 0;
+  int last_minutes = 0;
+
+  bool readVarint(std::uint64_t &out);
+
+public:
+  // returns error description on malformed header
+  std::optional<std::string> open(const std::string &data);
+
+  const ClubConfig &getConfiguration() const;
+  const std::vector<std::string> &getDictionary() const;
+
+  // false on end of records; error is set on malformed record
+  bool next(Record &record, std::optional<std::string> &error);
+};
+
+// LEB128 helpers, shared with the other archive formats
+void writeVarint(std::string &out, std::uint64_t value);
+// false on truncated or over-long input, cursor is advanced past the value
+bool readVarint(const std::uint8_t *&cursor, const std::uint8_t *end,
+                std::uint64_t &out);
+// length-prefixed byte strings
+void writeBytes(std::string &out, const std::string &bytes);
+bool readBytes(const std::uint8_t *&cursor, const std::uint8_t *end,
+               std::string &out);
+
+// true for a regular file with a valid header; anything else, including
+// pipes and devices, is read as text
+bool isBinaryEventFile(const std::string &path);
+
+// returns error description on failure
+std::optional<std::string> convertTextToBinary(std::istream &text_input,
+                                               std::ostream &binary_output);
+std::optional<std::string> convertBinaryToText(std::istream &binary_input,
+                                               std::ostream &text_output);
+
+} // namespace binary_format
@@ -0,0 +1,495 @@
+#include "club_async_io.h"
+
+#ifdef CLUB_HAS_ASYNC_IO
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef CLUB_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+constexpr std::size_t kBufferAlignment = 4096;
+
+char *allocateBuffer(std::size_t size) {
+  return static_cast<char *>(
+      ::operator new(size, std::align_val_t(kBufferAlignment)));
+}
+
+void freeBuffer(char *buffer) {
+  ::operator delete(buffer, std::align_val_t(kBufferAlignment));
+}
+
+// Bookkeeping after the kernel moved result bytes (or failed with -errno).
+// Returns true when the request is complete, false when the rest must be
+// submitted again.
+bool advanceRequest(IoRequest &request, std::int64_t result) {
+  if (result == -EINTR || result == -EAGAIN) {
+    return false;
+  }
+  if (result < 0) {
+    request.result = result;
+    return true;
+  }
+  if (result == 0) {
+    // end of file for a read; a write that moves nothing would spin
+    request.result = request.write ? -EIO
+                                   : static_cast<std::int64_t>(
+                                         request.transferred);
+    return true;
+  }
+  request.transferred += static_cast<std::size_t>(result);
+  if (request.transferred < request.length && !request.partial) {
+    return false;
+  }
+  request.result = static_cast<std::int64_t>(request.transferred);
+  return true;
+}
+
+// --- pread/write on a helper thread, requests run in submission order ---
+class ThreadIoBackend : public AsyncIoBackend {
+private:
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<IoRequest *> queue;
+  bool stopping = false;
+  std::thread worker;
+
+  static std::int64_t transferOnce(IoRequest &request) {
+    char *data = request.data + request.transferred;
+    std::size_t length = request.length - request.transferred;
+    ssize_t moved;
+    if (request.offset < 0) {
+      moved = request.write ? ::write(request.fd, data, length)
+                            : ::read(request.fd, data, length);
+    } else {
+      off_t offset = static_cast<off_t>(request.offset + request.transferred);
+      moved = request.write ? ::pwrite(request.fd, data, length, offset)
+                            : ::pread(request.fd, data, length, offset);
+    }
+    return moved < 0 ? -errno : moved;
+  }
+
+  void run() {
+    std::unique_lock lock(mutex);
+    while (true) {
+      changed.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+      IoRequest &request = *queue.front();
+      queue.pop_front();
+      lock.unlock();
+      while (!advanceRequest(request, transferOnce(request))) {
+      }
+      lock.lock();
+      request.in_flight = false;
+      changed.notify_all();
+    }
+  }
+
+public:
+  ThreadIoBackend() : worker([this] { run(); }) {}
+  ~ThreadIoBackend() override {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+  }
+
+  void submit(IoRequest &request) override {
+    std::lock_guard lock(mutex);
+    request.transferred = 0;
+    request.in_flight = true;
+    queue.push_back(&request);
+    changed.notify_all();
+  }
+
+  void wait(IoRequest &request) override {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [&request] { return !request.in_flight; });
+  }
+
+  const char *name() const override { return "threads"; }
+};
+
+#ifdef CLUB_HAS_IO_URING
+// --- io_uring through raw syscalls, no liburing ---
+// Used from one thread. Without SQPOLL the kernel consumes submissions
+// inside io_uring_enter, so the submission ring never fills.
+class UringIoBackend : public AsyncIoBackend {
+private:
+  static constexpr unsigned kEntries = 16;
+
+  int ring_fd = -1;
+  void *sq_ring = MAP_FAILED;
+  std::size_t sq_ring_size = 0;
+  void *cq_ring = MAP_FAILED;
+  std::size_t cq_ring_size = 0;
+  io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  std::size_t sqes_size = 0;
+
+  unsigned *sq_tail = nullptr;
+  unsigned *sq_mask = nullptr;
+  unsigned *sq_array = nullptr;
+  unsigned *cq_head = nullptr;
+  unsigned *cq_tail = nullptr;
+  unsigned *cq_mask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+
+  int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    long result;
+    do {
+      result = ::syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                         min_complete, flags, nullptr, 0);
+    } while (result < 0 && errno == EINTR);
+    return result < 0 ? -errno : static_cast<int>(result);
+  }
+
+  void enqueue(IoRequest &request) {
+    unsigned tail = *sq_tail;
+    unsigned index = tail & *sq_mask;
+    io_uring_sqe &sqe = sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe.fd = request.fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(request.data +
+                                               request.transferred);
+    sqe.len = static_cast<std::uint32_t>(request.length - request.transferred);
+    // all ones selects the current file position
+    sqe.off = request.offset < 0
+                  ? ~std::uint64_t{0}
+                  : static_cast<std::uint64_t>(request.offset) +
+                        request.transferred;
+    sqe.user_data = reinterpret_cast<std::uint64_t>(&request);
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    int submitted = enter(1, 0, 0);
+    if (submitted < 0) {
+      // the entry was not consumed, take it back and fail the request
+      __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+      request.result = submitted;
+      request.in_flight = false;
+    }
+  }
+
+  // handles one completion, blocking for it if none is ready; -errno if
+  // the kernel refuses to wait
+  int reapOne() {
+    unsigned head = *cq_head;
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+      int waited = enter(0, 1, IORING_ENTER_GETEVENTS);
+      return waited < 0 ? waited : 0;
+    }
+    const io_uring_cqe &cqe = cqes[head & *cq_mask];
+    auto *request = reinterpret_cast<IoRequest *>(cqe.user_data);
+    std::int64_t result = cqe.res;
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    if (advanceRequest(*request, result)) {
+      request->in_flight = false;
+    } else {
+      enqueue(*request);
+    }
+    return 0;
+  }
+
+public:
+  // false if the kernel refuses the ring or lacks current-position I/O
+  bool open() {
+    io_uring_params params{};
+    long fd = ::syscall(__NR_io_uring_setup, kEntries, &params);
+    if (fd < 0) {
+      return false;
+    }
+    ring_fd = static_cast<int>(fd);
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+      return false;
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+    sq_ring = ::mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+      return false;
+    }
+    if (single_mmap) {
+      cq_ring = sq_ring;
+    } else {
+      cq_ring = ::mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if (cq_ring == MAP_FAILED) {
+        return false;
+      }
+    }
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(
+        ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED) {
+      return false;
+    }
+
+    char *sq = static_cast<char *>(sq_ring);
+    sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cq_ring);
+    cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  ~UringIoBackend() override {
+    if (sqes != MAP_FAILED) {
+      ::munmap(sqes, sqes_size);
+    }
+    if (cq_ring != MAP_FAILED && cq_ring != sq_ring) {
+      ::munmap(cq_ring, cq_ring_size);
+    }
+    if (sq_ring != MAP_FAILED) {
+      ::munmap(sq_ring, sq_ring_size);
+    }
+    if (ring_fd >= 0) {
+      ::close(ring_fd);
+    }
+  }
+
+  void submit(IoRequest &request) override {
+    request.transferred = 0;
+    request.in_flight = true;
+    enqueue(request);
+  }
+
+  void wait(IoRequest &request) override {
+    while (request.in_flight) {
+      int error = reapOne();
+      if (error < 0) {
+        // the ring is unusable, fail the request like enqueue does
+        request.result = error;
+        request.in_flight = false;
+      }
+    }
+  }
+
+  const char *name() const override { return "io_uring"; }
+};
+
+std::unique_ptr<AsyncIoBackend> openUringBackend() {
+  auto backend = std::make_unique<UringIoBackend>();
+  if (!backend->open()) {
+    return nullptr;
+  }
+  return backend;
+}
+#else
+std::unique_ptr<AsyncIoBackend> openUringBackend() { return nullptr; }
+#endif
+
+} // namespace
+
+bool isIoUringSupported() { return openUringBackend() != nullptr; }
+
+std::unique_ptr<AsyncIoBackend> makeAsyncIoBackend(AsyncIoMode mode,
+                                                   std::string *error) {
+  if (mode != AsyncIoMode::THREAD) {
+    std::unique_ptr<AsyncIoBackend> backend = openUringBackend();
+    if (backend != nullptr) {
+      return backend;
+    }
+    if (mode == AsyncIoMode::URING) {
+      if (error != nullptr) {
+        *error = "io_uring is not available";
+      }
+      return nullptr;
+    }
+  }
+  return std::make_unique<ThreadIoBackend>();
+}
+
+// --- class AsyncReadBuffer ---
+AsyncReadBuffer::AsyncReadBuffer(int fd, AsyncIoBackend &backend,
+                                 std::size_t buffer_size,
+                                 std::size_t buffer_count)
+    : backend(backend), buffer_size(buffer_size), current(buffer_count) {
+  struct stat file_stat {};
+  positioned = ::fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+  // reads at the file position must not overtake each other
+  slots.resize(positioned ? std::max<std::size_t>(buffer_count, 2) : 2);
+  current = slots.size();
+  for (Slot &slot : slots) {
+    slot.data = allocateBuffer(buffer_size);
+    slot.request.fd = fd;
+  }
+  for (std::size_t i = 0; i < (positioned ? slots.size() : 1); ++i) {
+    submitRead(i);
+  }
+}
+
+AsyncReadBuffer::~AsyncReadBuffer() {
+  for (Slot &slot : slots) {
+    if (slot.submitted) {
+      backend.wait(slot.request);
+    }
+    freeBuffer(slot.data);
+  }
+}
+
+void AsyncReadBuffer::submitRead(std::size_t slot) {
+  if (end_reached) {
+    return;
+  }
+  IoRequest &request = slots[slot].request;
+  request.write = false;
+  request.data = slots[slot].data;
+  request.length = buffer_size;
+  request.offset = positioned ? static_cast<std::int64_t>(next_offset) : -1;
+  request.partial = !positioned;
+  next_offset += buffer_size;
+  slots[slot].submitted = true;
+  backend.submit(request);
+}
+
+AsyncReadBuffer::int_type AsyncReadBuffer::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  bool first = current == slots.size();
+  if (!first && positioned) {
+    // the consumed buffer goes to the back of the read-ahead queue
+    submitRead(current);
+  }
+  std::size_t slot = first ? 0 : (current + 1) % slots.size();
+  IoRequest &request = slots[slot].request;
+  setg(nullptr, nullptr, nullptr);
+  if (!slots[slot].submitted) {
+    return traits_type::eof();
+  }
+  backend.wait(request);
+  slots[slot].submitted = false;
+  current = slot;
+  if (request.result < 0) {
+    read_errno = static_cast<int>(-request.result);
+    end_reached = true;
+    return traits_type::eof();
+  }
+  auto length = static_cast<std::size_t>(request.result);
+  // a pipe returns what has arrived, only an empty read is its end
+  if (length == 0 || (positioned && length < buffer_size)) {
+    end_reached = true;
+  }
+  if (!positioned) {
+    submitRead((slot + 1) % slots.size());
+  }
+  if (length == 0) {
+    return traits_type::eof();
+  }
+  char *data = slots[slot].data;
+  setg(data, data, data + length);
+  return traits_type::to_int_type(*data);
+}
+
+std::optional<std::string> AsyncReadBuffer::error() const {
+  if (read_errno == 0) {
+    return std::nullopt;
+  }
+  return std::strerror(read_errno);
+}
+
+// --- class AsyncWriteBuffer ---
+AsyncWriteBuffer::AsyncWriteBuffer(int fd, AsyncIoBackend &backend,
+                                   std::size_t buffer_size)
+    : fd(fd), backend(backend), buffer_size(buffer_size) {
+  for (Slot &slot : slots) {
+    slot.data = allocateBuffer(buffer_size);
+  }
+  setp(slots[0].data, slots[0].data + buffer_size);
+}
+
+AsyncWriteBuffer::~AsyncWriteBuffer() {
+  sync();
+  for (Slot &slot : slots) {
+    freeBuffer(slot.data);
+  }
+}
+
+void AsyncWriteBuffer::waitSlot(Slot &slot) {
+  if (!slot.submitted) {
+    return;
+  }
+  backend.wait(slot.request);
+  slot.submitted = false;
+  if (slot.request.result < 0 && write_errno == 0) {
+    write_errno = static_cast<int>(-slot.request.result);
+  }
+}
+
+void AsyncWriteBuffer::submitCurrent() {
+  auto length = static_cast<std::size_t>(pptr() - pbase());
+  if (length == 0) {
+    return;
+  }
+  Slot &filled = slots[current];
+  Slot &other = slots[1 - current];
+  // one write in flight keeps the output in order at the file position
+  waitSlot(other);
+  filled.request.fd = fd;
+  filled.request.write = true;
+  filled.request.data = filled.data;
+  filled.request.length = length;
+  filled.request.offset = -1;
+  filled.submitted = true;
+  backend.submit(filled.request);
+  current = 1 - current;
+  setp(other.data, other.data + buffer_size);
+}
+
+AsyncWriteBuffer::int_type AsyncWriteBuffer::overflow(int_type ch) {
+  submitCurrent();
+  if (write_errno != 0) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+int AsyncWriteBuffer::sync() {
+  submitCurrent();
+  waitSlot(slots[0]);
+  waitSlot(slots[1]);
+  return write_errno == 0 ? 0 : -1;
+}
+
+std::optional<std::string> AsyncWriteBuffer::finish() {
+  if (sync() == 0) {
+    return std::nullopt;
+  }
+  return std::strerror(write_errno);
+}
+
+#endif
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Asynchronous file I/O behind std::streambuf, so the runners keep their
+// std::istream / std::ostream interface. Reads are kept ahead of the parser
+// and writes behind the formatter in large page-aligned buffers; the CPU
+// works on one buffer while the kernel fills or drains another.
+//
+// Two backends: io_uring through raw syscalls where the kernel headers and
+// the kernel support it, and a thread doing pread/write otherwise.
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CLUB_HAS_ASYNC_IO 1
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define CLUB_HAS_IO_URING 1
+#endif
+
+enum class AsyncIoMode { AUTO, URING, THREAD };
+
+#ifdef CLUB_HAS_ASYNC_IO
+
+// --- one transfer, owned by the stream buffer that submits it ---
+struct IoRequest {
+  int fd = -1;
+  bool write = false;
+  char *data = nullptr;
+  std::size_t length = 0;
+  // -1: current file position, transfers on the fd then run in order
+  std::int64_t offset = -1;
+  // complete after any non-empty transfer, for reads of pipes and
+  // terminals that must not wait for the whole length to arrive
+  bool partial = false;
+
+  // filled by the backend: bytes moved, short only at end of file for a
+  // read (or for a partial one), or -errno
+  std::int64_t result = 0;
+  bool in_flight = false;
+
+  // progress of a transfer the kernel split, backend use only
+  std::size_t transferred = 0;
+};
+
+class AsyncIoBackend {
+public:
+  virtual ~AsyncIoBackend() = default;
+
+  // The backend moves the whole length unless end of file, an error or a
+  // partial request's first bytes come first. request must stay alive
+  // until wait() returns.
+  virtual void submit(IoRequest &request) = 0;
+  virtual void wait(IoRequest &request) = 0;
+  virtual const char *name() const = 0;
+};
+
+bool isIoUringSupported();
+// nullptr with error set when the requested backend is unavailable; AUTO
+// falls back to the thread backend
+std::unique_ptr<AsyncIoBackend>
+makeAsyncIoBackend(AsyncIoMode mode, std::string *error = nullptr);
+
+// --- read-ahead input ---
+class AsyncReadBuffer : public std::streambuf {
+public:
+  static constexpr std::size_t kDefaultBufferSize = 1 << 20;
+  static constexpr std::size_t kDefaultBufferCount = 4;
+
+  // fd is not closed; reads of a regular file run buffer_count - 1 ahead
+  // with pread, other files are read in order one buffer ahead and hand
+  // over whatever has arrived
+  AsyncReadBuffer(int fd, AsyncIoBackend &backend,
+                  std::size_t buffer_size = kDefaultBufferSize,
+                  std::size_t buffer_count = kDefaultBufferCount);
+  ~AsyncReadBuffer() override;
+  AsyncReadBuffer(const AsyncReadBuffer &) = delete;
+  AsyncReadBuffer &operator=(const AsyncReadBuffer &) = delete;
+
+  // description of the first read error, which the stream sees as end of
+  // file
+  std::optional<std::string> error() const;
+
+protected:
+  int_type underflow() override;
+
+private:
+  struct Slot {
+    char *data = nullptr;
+    IoRequest request;
+    // submitted and its result not taken yet; the request may have
+    // completed already
+    bool submitted = false;
+  };
+
+  AsyncIoBackend &backend;
+  std::size_t buffer_size;
+  std::vector<Slot> slots;
+  std::size_t current;
+  std::uint64_t next_offset = 0;
+  bool positioned;
+  bool end_reached = false;
+  int read_errno = 0;
+
+  void submitRead(std::size_t slot);
+};
+
+// --- write-behind output ---
+class AsyncWriteBuffer : public std::streambuf {
+public:
+  static constexpr std::size_t kDefaultBufferSize = 1 << 20;
+
+  // fd is not closed; writes go to the current file position in order,
+  // so the fd may be a pipe, a terminal or a file opened for append
+  AsyncWriteBuffer(int fd, AsyncIoBackend &backend,
+                   std::size_t buffer_size = kDefaultBufferSize);
+  ~AsyncWriteBuffer() override;
+  AsyncWriteBuffer(const AsyncWriteBuffer &) = delete;
+  AsyncWriteBuffer &operator=(const AsyncWriteBuffer &) = delete;
+
+  // writes what is buffered and waits for every transfer; returns error
+  // description of the first failed write
+  std::optional<std::string> finish();
+
+protected:
+  int_type overflow(int_type ch) override;
+  int sync() override;
+
+private:
+  struct Slot {
+    char *data = nullptr;
+    IoRequest request;
+    // submitted and its result not taken yet; the request may have
+    // completed already
+    bool submitted = false;
+  };
+
+  int fd;
+  AsyncIoBackend &backend;
+  std::size_t buffer_size;
+  // double buffering: the formatter fills one while the other is written
+  Slot slots[2];
+  std::size_t current = 0;
+  int write_errno = 0;
+
+  void waitSlot(Slot &slot);
+  void submitCurrent();
+};
+
+#endif
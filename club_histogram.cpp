@@ -0,0 +1,95 @@
+#include "club_histogram.h"
+
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+std::uint32_t LogLinearHistogram::bucketUpperBound(std::size_t index) {
+  if (index < kLinearLimit) {
+    return static_cast<std::uint32_t>(index);
+  }
+  int shift = static_cast<int>(index / kSubBuckets) - 1;
+  std::uint32_t lower = (kSubBuckets + index % kSubBuckets) << shift;
+  return lower + (1u << shift) - 1;
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram &other) {
+  if (other.total == 0) {
+    return;
+  }
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+  if (total == 0 || other.min_value < min_value) {
+    min_value = other.min_value;
+  }
+  if (other.max_value > max_value) {
+    max_value = other.max_value;
+  }
+  total += other.total;
+  sum_values += other.sum_values;
+}
+
+void LogLinearHistogram::clear() { *this = LogLinearHistogram(); }
+
+std::uint32_t LogLinearHistogram::valueAtQuantile(double quantile) const {
+  if (total == 0) {
+    return 0;
+  }
+  double clamped = quantile < 0 ? 0 : quantile > 1 ? 1 : quantile;
+  auto rank = static_cast<std::uint64_t>(
+      std::ceil(clamped * static_cast<double>(total)));
+  if (rank == 0) {
+    return min_value;
+  }
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      std::uint32_t bound = bucketUpperBound(i);
+      if (bound < min_value) {
+        return min_value;
+      }
+      return bound > max_value ? max_value : bound;
+    }
+  }
+  return max_value;
+}
+
+void ClubDistributions::merge(const ClubDistributions &other) {
+  session_minutes.merge(other.session_minutes);
+  queue_wait_minutes.merge(other.queue_wait_minutes);
+}
+
+void ClubDistributions::clear() {
+  session_minutes.clear();
+  queue_wait_minutes.clear();
+}
+
+namespace {
+
+void writeDistribution(const char *name, const LogLinearHistogram &histogram,
+                       std::ostream &output) {
+  output << name << " count " << histogram.count() << " p50 "
+         << histogram.valueAtQuantile(0.5) << " p95 "
+         << histogram.valueAtQuantile(0.95) << " p99 "
+         << histogram.valueAtQuantile(0.99) << " max " << histogram.max()
+         << " mean ";
+  if (histogram.count() == 0) {
+    output << "-\n";
+    return;
+  }
+  output << std::fixed << std::setprecision(1)
+         << static_cast<double>(histogram.sum()) /
+                static_cast<double>(histogram.count())
+         << '\n';
+}
+
+} // namespace
+
+void writeDistributions(const ClubDistributions &distributions,
+                        std::ostream &output) {
+  writeDistribution("session_minutes", distributions.session_minutes, output);
+  writeDistribution("queue_wait_minutes", distributions.queue_wait_minutes,
+                    output);
+}
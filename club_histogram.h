@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// --- log-linear histogram of minute durations, fixed memory ---
+// Values below kLinearLimit get a bucket each; above that every power of two
+// is split into kSubBuckets equal buckets, so a quantile is off by at most
+// 1/kSubBuckets of its value. Count, sum, min and max are exact. Histograms
+// of different days or clubs merge by adding buckets.
+class LogLinearHistogram {
+public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr std::uint32_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr std::uint32_t kLinearLimit = kSubBuckets;
+  // larger values are counted in the last bucket, their max stays exact
+  static constexpr int kValueBits = 16;
+  static constexpr std::uint32_t kMaxTrackedValue = (1u << kValueBits) - 1;
+  static constexpr std::size_t kBucketCount =
+      (kValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  static std::size_t bucketIndex(std::uint32_t value) {
+    if (value > kMaxTrackedValue) {
+      value = kMaxTrackedValue;
+    }
+    if (value < kLinearLimit) {
+      return value;
+    }
+    int exponent = std::bit_width(value) - 1;
+    int shift = exponent - kSubBucketBits;
+    return static_cast<std::size_t>(shift + 1) * kSubBuckets +
+           ((value >> shift) & (kSubBuckets - 1));
+  }
+  // largest value that falls into the bucket
+  static std::uint32_t bucketUpperBound(std::size_t index);
+
+  void record(std::uint32_t value) {
+    ++buckets[bucketIndex(value)];
+    if (total == 0 || value < min_value) {
+      min_value = value;
+    }
+    if (value > max_value) {
+      max_value = value;
+    }
+    ++total;
+    sum_values += value;
+  }
+
+  void merge(const LogLinearHistogram &other);
+  void clear();
+
+  std::uint64_t count() const { return total; }
+  std::uint64_t sum() const { return sum_values; }
+  // 0 for an empty histogram
+  std::uint32_t min() const { return min_value; }
+  std::uint32_t max() const { return max_value; }
+  // smallest bucket bound with at least quantile * count() values at or
+  // below it, clamped to [min(), max()]; 0 for an empty histogram
+  std::uint32_t valueAtQuantile(double quantile) const;
+  std::uint64_t bucketCount(std::size_t index) const { return buckets[index]; }
+
+  bool operator==(const LogLinearHistogram &other) const = default;
+
+private:
+  std::array<std::uint64_t, kBucketCount> buckets{};
+  std::uint64_t total = 0;
+  std::uint64_t sum_values = 0;
+  std::uint32_t min_value = 0;
+  std::uint32_t max_value = 0;
+};
+
+// --- duration distributions of a club, kept up to date by the engine ---
+struct ClubDistributions {
+  // minutes at a table of every finished session, end of day included
+  LogLinearHistogram session_minutes;
+  // minutes from joining the queue (ID 3) to being seated from it (ID 12)
+  LogLinearHistogram queue_wait_minutes;
+
+  void merge(const ClubDistributions &other);
+  void clear();
+
+  bool operator==(const ClubDistributions &other) const = default;
+};
+
+// one line per distribution:
+// <name> count <n> p50 <m> p95 <m> p99 <m> max <m> mean <m.m>
+void writeDistributions(const ClubDistributions &distributions,
+                        std::ostream &output);
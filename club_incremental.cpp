@@ -0,0 +1,294 @@
+#include "club_incremental.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "binary_format.h"
+#include "club_snapshot.h"
+
+namespace incremental {
+namespace {
+
+using binary_format::readBytes;
+using binary_format::readVarint;
+using binary_format::writeBytes;
+using binary_format::writeVarint;
+
+constexpr std::uint8_t kConfiguredFlag = 1;
+constexpr std::uint8_t kFinishedFlag = 2;
+
+std::uint64_t fnv1a(const std::string &bytes) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : bytes) {
+    hash ^= static_cast<std::uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+std::uint64_t streamSize(std::istream &input) {
+  input.clear();
+  input.seekg(0, std::ios::end);
+  std::streamoff size = input.tellg();
+  return size < 0 ? 0 : static_cast<std::uint64_t>(size);
+}
+
+// false if the stream holds fewer than length bytes at offset
+bool readRange(std::istream &input, std::uint64_t offset,
+               std::uint64_t length, std::string &out) {
+  out.resize(length);
+  input.clear();
+  input.seekg(static_cast<std::streamoff>(offset));
+  input.read(out.data(), static_cast<std::streamsize>(length));
+  return static_cast<std::uint64_t>(input.gcount()) == length;
+}
+
+// hashes of the two windows of the first offset bytes
+bool hashPrefix(std::istream &input, std::uint64_t offset,
+                std::uint64_t &head_hash, std::uint64_t &tail_hash) {
+  std::string window;
+  if (!readRange(input, 0, std::min(offset, kPrefixWindow), window)) {
+    return false;
+  }
+  head_hash = fnv1a(window);
+  std::uint64_t tail_start =
+      offset > kPrefixWindow ? offset - kPrefixWindow : 0;
+  if (!readRange(input, tail_start, offset - tail_start, window)) {
+    return false;
+  }
+  tail_hash = fnv1a(window);
+  return true;
+}
+
+// Only the windows at both ends are compared, so a run costs O(appended)
+// and not O(input); they catch truncation, a rewritten header and changes
+// to the last processed lines.
+bool prefixMatches(std::istream &input, const Sidecar &sidecar) {
+  if (sidecar.input_offset == 0) {
+    return true;
+  }
+  if (streamSize(input) < sidecar.input_offset) {
+    return false;
+  }
+  std::uint64_t head_hash, tail_hash;
+  return hashPrefix(input, sidecar.input_offset, head_hash, tail_hash) &&
+         head_hash == sidecar.head_hash && tail_hash == sidecar.tail_hash;
+}
+
+void advance(std::istream &input, Sidecar &sidecar, std::uint64_t consumed) {
+  sidecar.input_offset += consumed;
+  hashPrefix(input, sidecar.input_offset, sidecar.head_hash,
+             sidecar.tail_hash);
+}
+
+void writeNewEvents(const std::vector<Event> &event_log, std::size_t from,
+                    std::ostream &output) {
+  for (std::size_t i = from; i < event_log.size(); ++i) {
+    output << event_log[i].toString() << '\n';
+  }
+}
+
+template <typename Club>
+void feedAppendedLines(Club &club, std::istream &lines, Sidecar &sidecar,
+                       std::ostream &output, bool end_of_day,
+                       const RunOptions &options) {
+  // the restored engine starts with an empty log, so all of it is new
+  std::ostringstream rejected_line;
+  bool rejected = false;
+  std::string event_line_str;
+  while (std::getline(lines, event_line_str)) {
+    if (!feedEventLine(club, event_line_str, sidecar.stream, rejected_line)) {
+      rejected = true;
+      break;
+    }
+  }
+  writeNewEvents(club.getEventLog(), 0, output);
+
+  if (rejected) {
+    output << rejected_line.str();
+    sidecar.finished = true;
+    sidecar.state.clear();
+  } else if (end_of_day) {
+    std::size_t printed = club.getEventLog().size();
+    club.processEndOfDay();
+    writeNewEvents(club.getEventLog(), printed, output);
+    output << club.getCloseTime().toString() << '\n';
+    writeReportTail(club, options.top_spenders, output);
+    sidecar.finished = true;
+    sidecar.state.clear();
+  } else {
+    sidecar.state = club_snapshot::encode(club.saveSnapshot());
+  }
+}
+
+} // namespace
+
+std::string encode(const Sidecar &sidecar) {
+  std::string out(kMagic, sizeof(kMagic));
+  out.push_back(static_cast<char>(kVersion));
+  out.push_back(static_cast<char>((sidecar.configured ? kConfiguredFlag : 0) |
+                                  (sidecar.finished ? kFinishedFlag : 0)));
+  writeVarint(out, sidecar.input_offset);
+  writeVarint(out, sidecar.head_hash);
+  writeVarint(out, sidecar.tail_hash);
+  writeVarint(out, sidecar.stream.last_event_time.toMinutes());
+  out.push_back(static_cast<char>(sidecar.stream.first_event ? 1 : 0));
+  writeBytes(out, sidecar.state);
+  return out;
+}
+
+std::optional<std::string> decode(const std::string &data, Sidecar &sidecar) {
+  const auto *cursor = reinterpret_cast<const std::uint8_t *>(data.data());
+  const std::uint8_t *end = cursor + data.size();
+  if (data.size() < sizeof(kMagic) + 2 ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return "not an incremental sidecar";
+  }
+  cursor += sizeof(kMagic);
+  if (*cursor++ != kVersion) {
+    return "unsupported sidecar version";
+  }
+  std::uint8_t flags = *cursor++;
+  if ((flags & ~(kConfiguredFlag | kFinishedFlag)) != 0) {
+    return "unknown sidecar flags";
+  }
+
+  Sidecar result;
+  result.configured = (flags & kConfiguredFlag) != 0;
+  result.finished = (flags & kFinishedFlag) != 0;
+  std::uint64_t last_minutes;
+  if (!readVarint(cursor, end, result.input_offset) ||
+      !readVarint(cursor, end, result.head_hash) ||
+      !readVarint(cursor, end, result.tail_hash) ||
+      !readVarint(cursor, end, last_minutes) || cursor == end) {
+    return "truncated sidecar";
+  }
+  if (last_minutes >= 24 * 60 || *cursor > 1) {
+    return "invalid stream position in sidecar";
+  }
+  result.stream.last_event_time = Time(static_cast<int>(last_minutes));
+  result.stream.first_event = *cursor++ == 1;
+  if (!readBytes(cursor, end, result.state) || cursor != end) {
+    return "truncated sidecar";
+  }
+  if (result.configured && !result.finished) {
+    ClubStateSnapshot snapshot;
+    std::optional<std::string> error =
+        club_snapshot::decode(result.state, snapshot);
+    if (error.has_value()) {
+      return "club state in sidecar: " + error.value();
+    }
+  }
+  sidecar = std::move(result);
+  return std::nullopt;
+}
+
+AppendedRun runAppended(std::istream &input, Sidecar &sidecar,
+                        std::ostream &output, bool end_of_day,
+                        const RunOptions &options) {
+  AppendedRun run;
+  ClubStateSnapshot snapshot;
+  bool state_ok = !sidecar.configured || sidecar.finished ||
+                  !club_snapshot::decode(sidecar.state, snapshot).has_value();
+  if (!state_ok || !prefixMatches(input, sidecar)) {
+    sidecar = Sidecar();
+    snapshot = ClubStateSnapshot();
+    run.restarted = true;
+  }
+  if (sidecar.finished) {
+    return run;
+  }
+
+  std::string appended;
+  std::uint64_t input_size = streamSize(input);
+  readRange(input, sidecar.input_offset, input_size - sidecar.input_offset,
+            appended);
+  run.bytes_read = appended.size();
+
+  // a line without its newline may still be being written
+  std::size_t usable = appended.size();
+  if (!end_of_day) {
+    std::size_t last_newline = appended.rfind('\n');
+    usable = last_newline == std::string::npos ? 0 : last_newline + 1;
+  }
+  std::istringstream lines(appended.substr(0, usable));
+
+  if (!sidecar.configured) {
+    if (!end_of_day &&
+        std::count(appended.begin(), appended.begin() + usable, '\n') < 3) {
+      return run;
+    }
+    std::optional<std::string> config_error =
+        loadClubConfiguration(lines, snapshot.config);
+    if (config_error.has_value()) {
+      output << config_error.value() << '\n';
+      sidecar.finished = true;
+      advance(input, sidecar, usable);
+      return run;
+    }
+    output << snapshot.config.open_time.toString() << '\n';
+    sidecar.configured = true;
+  }
+
+  withClubEngine(snapshot.config, [&](auto &club) {
+    club.restoreSnapshot(snapshot);
+    feedAppendedLines(club, lines, sidecar, output, end_of_day, options);
+  });
+  advance(input, sidecar, usable);
+  return run;
+}
+
+int runIncrementalFile(const std::string &input_path,
+                       const std::string &sidecar_path, std::ostream &output,
+                       std::ostream &errors, bool end_of_day,
+                       const RunOptions &options) {
+  if (binary_format::isBinaryEventFile(input_path)) {
+    errors << "Error: incremental runs need a text input" << std::endl;
+    return 1;
+  }
+  // binary mode, so offsets are byte offsets on every platform
+  std::ifstream input(input_path, std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    errors << "Error: Could not open file " << input_path << std::endl;
+    return 1;
+  }
+
+  Sidecar sidecar;
+  std::ifstream sidecar_file(sidecar_path, std::ios::in | std::ios::binary);
+  if (sidecar_file.is_open()) {
+    std::string data((std::istreambuf_iterator<char>(sidecar_file)),
+                     std::istreambuf_iterator<char>());
+    std::optional<std::string> error = decode(data, sidecar);
+    if (error.has_value()) {
+      errors << "Warning: ignoring " << sidecar_path << ": " << error.value()
+             << std::endl;
+    }
+  }
+
+  AppendedRun run = runAppended(input, sidecar, output, end_of_day, options);
+  if (run.restarted) {
+    errors << "Warning: " << input_path
+           << " changed before the processed offset, processed from the start"
+           << std::endl;
+  }
+
+  // replaced in one step, so a crash never leaves a half-written sidecar
+  std::string temporary_path = sidecar_path + ".tmp";
+  std::ofstream sidecar_out(temporary_path,
+                            std::ios::out | std::ios::binary | std::ios::trunc);
+  std::string data = encode(sidecar);
+  sidecar_out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  sidecar_out.close();
+  if (!sidecar_out ||
+      std::rename(temporary_path.c_str(), sidecar_path.c_str()) != 0) {
+    errors << "Error: Could not write file " << sidecar_path << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace incremental
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+#include "club_runner.h"
+#include "computer_club.h"
+
+// Incremental runs over a text input that grows during the day. A sidecar
+// remembers how far the input was processed and the engine state at that
+// point, so every run reads only the bytes appended since the previous one
+// and prints only the report lines they produce. The outputs of all runs
+// of a day, the last one with end_of_day, add up to the report of task,
+// except that a rejected line comes after the events already printed.
+//
+// Sidecar layout (version 1, LEB128 varints unless noted):
+//   "CCIS" magic, u8 version
+//   u8 flags: 1 = configuration read, 2 = day finished
+//   input offset, hash of the head window, hash of the tail window
+//   last event minutes, u8 first-event flag
+//   length + club_snapshot image without event log (empty until the
+//   configuration is read)
+namespace incremental {
+
+constexpr char kMagic[4] = {'C', 'C', 'I', 'S'};
+constexpr std::uint8_t kVersion = 1;
+// bytes at the start and before the offset checked on every run
+constexpr std::uint64_t kPrefixWindow = 4096;
+
+struct Sidecar {
+  bool configured = false;
+  // end of day applied or a line rejected, later runs print nothing
+  bool finished = false;
+  // input bytes consumed, always the start of a line
+  std::uint64_t input_offset = 0;
+  // FNV-1a of the first and of the last kPrefixWindow consumed bytes
+  std::uint64_t head_hash = 0;
+  std::uint64_t tail_hash = 0;
+  EventStreamState stream;
+  std::string state;
+};
+
+std::string encode(const Sidecar &sidecar);
+// returns error description on malformed data
+std::optional<std::string> decode(const std::string &data, Sidecar &sidecar);
+
+struct AppendedRun {
+  // the consumed prefix changed, so the input was processed from byte zero
+  bool restarted = false;
+  std::uint64_t bytes_read = 0;
+};
+
+// Processes the complete lines of input after sidecar.input_offset and
+// writes their report lines to output; a trailing line without newline is
+// left for the next run unless end_of_day is set. end_of_day also closes
+// the day and prints the closing part of the report (top_spenders of
+// options is honoured). input must be seekable. A default Sidecar starts
+// a new day.
+AppendedRun runAppended(std::istream &input, Sidecar &sidecar,
+                        std::ostream &output, bool end_of_day,
+                        const RunOptions &options = {});
+
+// runAppended on a file, with the sidecar loaded from and saved to
+// sidecar_path; a missing or unreadable sidecar starts a new day.
+// Return value is the process exit code.
+int runIncrementalFile(const std::string &input_path,
+                       const std::string &sidecar_path, std::ostream &output,
+                       std::ostream &errors, bool end_of_day,
+                       const RunOptions &options = {});
+
+} // namespace incremental
@@ -0,0 +1,191 @@
+#include "club_memory.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+#ifdef CLUB_HAS_MEMORY_ACCOUNTING
+#include <malloc.h>
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct SubsystemCounters {
+  std::atomic<std::int64_t> live_bytes{0};
+  std::atomic<std::int64_t> peak_bytes{0};
+  std::atomic<std::uint64_t> allocations{0};
+};
+
+// constant-initialized, so usable by allocations made during static init
+std::atomic<bool> accounting_enabled{false};
+SubsystemCounters subsystem_counters[kMemorySubsystemCount];
+std::atomic<std::int64_t> total_live_bytes{0};
+std::atomic<std::int64_t> total_peak_bytes{0};
+
+void raisePeak(std::atomic<std::int64_t> &peak, std::int64_t value) {
+  std::int64_t current = peak.load(std::memory_order_relaxed);
+  while (value > current &&
+         !peak.compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+#ifdef CLUB_HAS_MEMORY_ACCOUNTING
+void countAllocation(void *block) {
+  auto size = static_cast<std::int64_t>(malloc_usable_size(block));
+  SubsystemCounters &counters = subsystem_counters[static_cast<std::size_t>(
+      current_memory_subsystem)];
+  raisePeak(counters.peak_bytes,
+            counters.live_bytes.fetch_add(size, std::memory_order_relaxed) +
+                size);
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  raisePeak(total_peak_bytes,
+            total_live_bytes.fetch_add(size, std::memory_order_relaxed) +
+                size);
+}
+
+void countRelease(void *block) {
+  auto size = static_cast<std::int64_t>(malloc_usable_size(block));
+  subsystem_counters[static_cast<std::size_t>(current_memory_subsystem)]
+      .live_bytes.fetch_sub(size, std::memory_order_relaxed);
+  total_live_bytes.fetch_sub(size, std::memory_order_relaxed);
+}
+#endif
+
+void writeBytesPer(std::ostream &output, const char *label,
+                   std::int64_t bytes, std::uint64_t units) {
+  output << label << ' ';
+  if (units == 0) {
+    output << "-\n";
+    return;
+  }
+  output << std::fixed << std::setprecision(1)
+         << static_cast<double>(bytes) / static_cast<double>(units) << '\n';
+}
+
+} // namespace
+
+#ifdef CLUB_HAS_MEMORY_ACCOUNTING
+// --- counting replacements of the global allocation functions ---
+// Array, nothrow and sized forms of libstdc++ forward to these two.
+void *operator new(std::size_t size) {
+  void *block;
+  while ((block = std::malloc(size == 0 ? 1 : size)) == nullptr) {
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+  if (accounting_enabled.load(std::memory_order_relaxed)) {
+    countAllocation(block);
+  }
+  return block;
+}
+
+void operator delete(void *block) noexcept {
+  if (block != nullptr && accounting_enabled.load(std::memory_order_relaxed)) {
+    countRelease(block);
+  }
+  std::free(block);
+}
+
+void operator delete(void *block, std::size_t) noexcept {
+  operator delete(block);
+}
+#endif
+
+const char *memorySubsystemName(MemorySubsystem subsystem) {
+  switch (subsystem) {
+  case MemorySubsystem::OTHER:
+    return "other";
+  case MemorySubsystem::CLIENT_STATE:
+    return "client_state";
+  case MemorySubsystem::QUEUE:
+    return "queue";
+  case MemorySubsystem::EVENT_LOG:
+    return "event_log";
+  case MemorySubsystem::TABLE_STATE:
+    return "table_state";
+  case MemorySubsystem::STRINGS:
+    return "strings";
+  }
+  return "unknown";
+}
+
+bool isMemoryAccountingSupported() {
+#ifdef CLUB_HAS_MEMORY_ACCOUNTING
+  return true;
+#else
+  return false;
+#endif
+}
+
+void enableMemoryAccounting() {
+  accounting_enabled.store(false, std::memory_order_relaxed);
+  for (SubsystemCounters &counters : subsystem_counters) {
+    counters.live_bytes.store(0, std::memory_order_relaxed);
+    counters.peak_bytes.store(0, std::memory_order_relaxed);
+    counters.allocations.store(0, std::memory_order_relaxed);
+  }
+  total_live_bytes.store(0, std::memory_order_relaxed);
+  total_peak_bytes.store(0, std::memory_order_relaxed);
+  accounting_enabled.store(true, std::memory_order_relaxed);
+}
+
+void disableMemoryAccounting() {
+  accounting_enabled.store(false, std::memory_order_relaxed);
+}
+
+MemoryReport readMemoryUsage() {
+  MemoryReport report;
+  for (std::size_t i = 0; i < kMemorySubsystemCount; ++i) {
+    const SubsystemCounters &counters = subsystem_counters[i];
+    report.subsystems[i].live_bytes =
+        counters.live_bytes.load(std::memory_order_relaxed);
+    report.subsystems[i].peak_bytes =
+        counters.peak_bytes.load(std::memory_order_relaxed);
+    report.subsystems[i].allocations =
+        counters.allocations.load(std::memory_order_relaxed);
+  }
+  report.peak_heap_bytes = total_peak_bytes.load(std::memory_order_relaxed);
+#ifdef CLUB_HAS_MEMORY_ACCOUNTING
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // kilobytes on Linux
+    report.peak_resident_bytes =
+        static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+  }
+#endif
+  return report;
+}
+
+void writeMemoryReport(const MemoryReport &report, std::ostream &output) {
+  output << "subsystem live_bytes peak_bytes allocations\n";
+  for (std::size_t i = 0; i < kMemorySubsystemCount; ++i) {
+    const MemoryUsage &usage = report.subsystems[i];
+    output << memorySubsystemName(static_cast<MemorySubsystem>(i)) << ' '
+           << usage.live_bytes << ' ' << usage.peak_bytes << ' '
+           << usage.allocations << '\n';
+  }
+  output << "peak_heap_bytes " << report.peak_heap_bytes << '\n'
+         << "peak_resident_bytes " << report.peak_resident_bytes << '\n'
+         << "engine_object_bytes " << report.engine_object_bytes << '\n'
+         << "events " << report.events << '\n'
+         << "clients " << report.clients << '\n';
+
+  auto live = [&report](MemorySubsystem subsystem) {
+    return report.subsystems[static_cast<std::size_t>(subsystem)].live_bytes;
+  };
+  writeBytesPer(output, "heap_bytes_per_event", report.peak_heap_bytes,
+                report.events);
+  writeBytesPer(output, "event_log_bytes_per_event",
+                live(MemorySubsystem::EVENT_LOG), report.events);
+  writeBytesPer(output, "client_bytes_per_client",
+                live(MemorySubsystem::CLIENT_STATE) +
+                    live(MemorySubsystem::STRINGS),
+                report.clients);
+}
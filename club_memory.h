@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Heap accounting per engine subsystem, for sizing deployments. The global
+// operator new/delete of every program linking club_logic are replaced by
+// counting versions (club_memory.cpp). Engine containers tag their
+// allocations with MemoryScope inside the methods that grow and shrink
+// them, so a block is normally released under the tag it was allocated
+// with. Counting stays off until enableMemoryAccounting(); until then an
+// allocation costs one extra relaxed load.
+
+#if defined(__GLIBC__)
+#define CLUB_HAS_MEMORY_ACCOUNTING 1
+#endif
+
+enum class MemorySubsystem : std::uint8_t {
+  OTHER, // I/O buffers, parsing temporaries, report strings
+  CLIENT_STATE,
+  QUEUE,
+  EVENT_LOG,
+  TABLE_STATE,
+  STRINGS, // interned client names
+};
+
+constexpr std::size_t kMemorySubsystemCount = 6;
+
+const char *memorySubsystemName(MemorySubsystem subsystem);
+
+// subsystem charged for allocations of the calling thread
+inline thread_local MemorySubsystem current_memory_subsystem =
+    MemorySubsystem::OTHER;
+
+// --- tags allocations of the calling thread for the scope's lifetime ---
+class MemoryScope {
+private:
+  MemorySubsystem previous;
+
+public:
+  explicit MemoryScope(MemorySubsystem subsystem)
+      : previous(current_memory_subsystem) {
+    current_memory_subsystem = subsystem;
+  }
+  ~MemoryScope() { current_memory_subsystem = previous; }
+  MemoryScope(const MemoryScope &) = delete;
+  MemoryScope &operator=(const MemoryScope &) = delete;
+};
+
+// Byte counts are allocator chunk sizes (malloc_usable_size), so they
+// include the rounding of the allocator but not its per-chunk header.
+struct MemoryUsage {
+  // may go negative for OTHER when blocks allocated before accounting
+  // was enabled are freed
+  std::int64_t live_bytes = 0;
+  std::int64_t peak_bytes = 0;
+  std::uint64_t allocations = 0;
+};
+
+struct MemoryReport {
+  std::array<MemoryUsage, kMemorySubsystemCount> subsystems;
+  // peak of the sum over all subsystems
+  std::int64_t peak_heap_bytes = 0;
+  std::uint64_t peak_resident_bytes = 0;
+  // sizeof the engine; inline table and queue storage lives there and not
+  // on the heap
+  std::uint64_t engine_object_bytes = 0;
+  // filled by the caller, the denominators of the per-unit figures
+  std::uint64_t events = 0;
+  std::uint64_t clients = 0;
+};
+
+// false when the platform has no counting hook
+bool isMemoryAccountingSupported();
+// starts counting from zero
+void enableMemoryAccounting();
+void disableMemoryAccounting();
+// counters so far and the peak resident set of the process
+MemoryReport readMemoryUsage();
+
+// one line per subsystem, then totals and bytes per event and per client
+void writeMemoryReport(const MemoryReport &report, std::ostream &output);
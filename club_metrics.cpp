@@ -0,0 +1,184 @@
+#include "club_metrics.h"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef CLUB_HAS_SHARED_METRICS
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void initMetricsBlock(MetricsBlock &block) {
+  block.magic = MetricsBlock::kMagic;
+  block.version = MetricsBlock::kVersion;
+  for (std::atomic<std::uint64_t> *field :
+       {&block.sequence, &block.events_processed, &block.num_tables,
+        &block.occupied_tables, &block.queue_length, &block.clients_inside,
+        &block.revenue, &block.last_event_minutes, &block.updated_ns,
+        &block.day_finished}) {
+    field->store(0, std::memory_order_relaxed);
+  }
+  block.updated_ns.store(steadyClockNs(), std::memory_order_release);
+}
+
+bool readMetrics(const MetricsBlock &block, MetricsSnapshot &snapshot) {
+  if (block.magic != MetricsBlock::kMagic ||
+      block.version != MetricsBlock::kVersion) {
+    return false;
+  }
+  for (int attempt = 0; attempt < kMaxMetricsReadAttempts; ++attempt) {
+    std::uint64_t before = block.sequence.load(std::memory_order_acquire);
+    if (before % 2 == 0) {
+      snapshot.events_processed =
+          block.events_processed.load(std::memory_order_relaxed);
+      snapshot.num_tables = block.num_tables.load(std::memory_order_relaxed);
+      snapshot.occupied_tables =
+          block.occupied_tables.load(std::memory_order_relaxed);
+      snapshot.queue_length =
+          block.queue_length.load(std::memory_order_relaxed);
+      snapshot.clients_inside =
+          block.clients_inside.load(std::memory_order_relaxed);
+      snapshot.revenue = block.revenue.load(std::memory_order_relaxed);
+      snapshot.last_event_minutes =
+          block.last_event_minutes.load(std::memory_order_relaxed);
+      snapshot.updated_ns = block.updated_ns.load(std::memory_order_relaxed);
+      snapshot.day_finished =
+          block.day_finished.load(std::memory_order_relaxed) != 0;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (block.sequence.load(std::memory_order_relaxed) == before) {
+        return true;
+      }
+    }
+    // a write takes nanoseconds, so spin first and only then give way
+    if (attempt >= 64) {
+      std::this_thread::yield();
+    }
+  }
+  return false;
+}
+
+std::uint64_t steadyClockNs() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// --- class MetricsWriter ---
+MetricsWriter::MetricsWriter(MetricsBlock &target)
+    : block(target),
+      sequence(target.sequence.load(std::memory_order_relaxed)) {}
+
+void MetricsWriter::setTableCount(int num_tables) {
+  beginWrite();
+  block.num_tables.store(num_tables, std::memory_order_relaxed);
+  endWrite();
+}
+
+// --- class SharedMetricsRegion ---
+#ifdef CLUB_HAS_SHARED_METRICS
+namespace {
+
+// A running writer keeps its object locked, so an object nobody locks was
+// left behind by a writer that died.
+bool isLeftoverObject(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    // gone already, or another user's object that cannot be taken over
+    return errno == ENOENT;
+  }
+  bool leftover = flock(fd, LOCK_EX | LOCK_NB) == 0;
+  ::close(fd);
+  return leftover;
+}
+
+} // namespace
+
+SharedMetricsRegion::~SharedMetricsRegion() {
+  if (mapped != nullptr) {
+    munmap(mapped, sizeof(MetricsBlock));
+  }
+  if (owner) {
+    shm_unlink(object_name.c_str());
+  }
+  if (lock_fd >= 0) {
+    ::close(lock_fd);
+  }
+}
+
+std::optional<std::string>
+SharedMetricsRegion::create(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0 && errno == EEXIST) {
+    if (!isLeftoverObject(name)) {
+      return name + " is in use by another writer";
+    }
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  }
+  if (fd < 0) {
+    return "shm_open " + name + ": " + std::strerror(errno);
+  }
+  if (flock(fd, LOCK_EX | LOCK_NB) != 0 ||
+      ftruncate(fd, sizeof(MetricsBlock)) != 0) {
+    std::string error = std::strerror(errno);
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return "shm_open " + name + ": " + error;
+  }
+  void *memory = mmap(nullptr, sizeof(MetricsBlock), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED) {
+    std::string error = std::strerror(errno);
+    ::close(fd);
+    shm_unlink(name.c_str());
+    return "mmap " + name + ": " + error;
+  }
+  mapped = new (memory) MetricsBlock;
+  object_name = name;
+  owner = true;
+  lock_fd = fd;
+  initMetricsBlock(*mapped);
+  return std::nullopt;
+}
+
+std::optional<std::string> SharedMetricsRegion::open(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return "shm_open " + name + ": " + std::strerror(errno);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      info.st_size < static_cast<off_t>(sizeof(MetricsBlock))) {
+    ::close(fd);
+    return name + " is not a metrics block";
+  }
+  void *memory = mmap(nullptr, sizeof(MetricsBlock), PROT_READ, MAP_SHARED,
+                      fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    return "mmap " + name + ": " + std::strerror(errno);
+  }
+  mapped = static_cast<MetricsBlock *>(memory);
+  object_name = name;
+  return std::nullopt;
+}
+#else
+SharedMetricsRegion::~SharedMetricsRegion() = default;
+
+std::optional<std::string> SharedMetricsRegion::create(const std::string &) {
+  return "shared memory metrics need a POSIX system";
+}
+
+std::optional<std::string> SharedMetricsRegion::open(const std::string &) {
+  return "shared memory metrics need a POSIX system";
+}
+#endif
+
+MetricsBlock *SharedMetricsRegion::block() const { return mapped; }
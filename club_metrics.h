@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "computer_club.h"
+
+// Live metrics of a running club in a fixed-layout block, meant to be
+// placed in POSIX shared memory for a monitoring agent. One writer (the
+// thread processing events) updates the block under a seqlock: readers
+// retry while a write is in progress and never block the writer.
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CLUB_HAS_SHARED_METRICS 1
+#endif
+
+// Layout (version 1): u32 magic "CCMB", u32 version, then 64-bit atomic
+// counters in the order below, 88 bytes in total, native byte order.
+struct MetricsBlock {
+  static constexpr std::uint32_t kMagic = 0x424D4343; // "CCMB"
+  static constexpr std::uint32_t kVersion = 1;
+
+  std::uint32_t magic;
+  std::uint32_t version;
+  // odd while the writer updates the fields below
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<std::uint64_t> events_processed;
+  std::atomic<std::uint64_t> num_tables;
+  std::atomic<std::uint64_t> occupied_tables;
+  std::atomic<std::uint64_t> queue_length;
+  std::atomic<std::uint64_t> clients_inside;
+  std::atomic<std::uint64_t> revenue;
+  std::atomic<std::uint64_t> last_event_minutes;
+  // steady clock of the writer in ns, refreshed every kClockInterval events
+  std::atomic<std::uint64_t> updated_ns;
+  std::atomic<std::uint64_t> day_finished;
+};
+
+static_assert(sizeof(MetricsBlock) == 88);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared metrics need lock-free 64-bit atomics");
+
+// consistent copy of the block
+struct MetricsSnapshot {
+  std::uint64_t events_processed = 0;
+  std::uint64_t num_tables = 0;
+  std::uint64_t occupied_tables = 0;
+  std::uint64_t queue_length = 0;
+  std::uint64_t clients_inside = 0;
+  std::uint64_t revenue = 0;
+  std::uint64_t last_event_minutes = 0;
+  std::uint64_t updated_ns = 0;
+  bool day_finished = false;
+};
+
+// zero-fills the block and stamps magic and version
+void initMetricsBlock(MetricsBlock &block);
+// false if the block has another magic or version, or if no consistent
+// copy turned up within kMaxMetricsReadAttempts: a writer that died in the
+// middle of an update leaves the sequence odd for good
+constexpr int kMaxMetricsReadAttempts = 1 << 16;
+bool readMetrics(const MetricsBlock &block, MetricsSnapshot &snapshot);
+std::uint64_t steadyClockNs();
+
+class MetricsWriter {
+private:
+  MetricsBlock &block;
+  std::uint64_t events = 0;
+  std::uint64_t sequence = 0;
+
+  void beginWrite() {
+    block.sequence.store(++sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  void endWrite() {
+    block.sequence.store(++sequence, std::memory_order_release);
+  }
+
+  template <typename Club>
+  void storeLoad(const Club &club, const Time &event_time) {
+    ClubLoad load = club.getLoad();
+    block.occupied_tables.store(load.occupied_tables,
+                                std::memory_order_relaxed);
+    block.queue_length.store(load.queue_length, std::memory_order_relaxed);
+    block.clients_inside.store(load.clients_inside,
+                               std::memory_order_relaxed);
+    block.revenue.store(load.revenue, std::memory_order_relaxed);
+    block.last_event_minutes.store(event_time.toMinutes(),
+                                   std::memory_order_relaxed);
+  }
+
+public:
+  static constexpr std::uint64_t kClockInterval = 1024;
+
+  // the block must be initialized, this is its only writer
+  explicit MetricsWriter(MetricsBlock &target);
+
+  void setTableCount(int num_tables);
+
+  // after every processed event: two sequence stores and one per field
+  template <typename Club>
+  void publish(const Club &club, const Time &event_time) {
+    beginWrite();
+    block.events_processed.store(++events, std::memory_order_relaxed);
+    storeLoad(club, event_time);
+    if (events % kClockInterval == 0) {
+      block.updated_ns.store(steadyClockNs(), std::memory_order_relaxed);
+    }
+    endWrite();
+  }
+
+  // final figures after processEndOfDay
+  template <typename Club> void finish(const Club &club) {
+    beginWrite();
+    storeLoad(club, club.getCloseTime());
+    block.updated_ns.store(steadyClockNs(), std::memory_order_relaxed);
+    block.day_finished.store(1, std::memory_order_relaxed);
+    endWrite();
+  }
+};
+
+// --- metrics block mapped from a named POSIX shared memory object ---
+class SharedMetricsRegion {
+private:
+  MetricsBlock *mapped = nullptr;
+  std::string object_name;
+  bool owner = false;
+  // writer side: held open with an exclusive flock while the block lives
+  int lock_fd = -1;
+
+public:
+  SharedMetricsRegion() = default;
+  ~SharedMetricsRegion();
+  SharedMetricsRegion(const SharedMetricsRegion &) = delete;
+  SharedMetricsRegion &operator=(const SharedMetricsRegion &) = delete;
+
+  // Writer side: creates the object and initializes the block; the
+  // object is unlinked again on destruction. Names look like
+  // "/club_metrics". An object left behind by a writer that died is
+  // replaced, one of a running writer is an error.
+  std::optional<std::string> create(const std::string &name);
+  // reader side, maps an existing object read-only
+  std::optional<std::string> open(const std::string &name);
+
+  MetricsBlock *block() const;
+};
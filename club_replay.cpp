@@ -0,0 +1,180 @@
+#include "club_replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <sstream>
+
+#include "binary_format.h"
+#include "club_runner.h"
+#include "club_snapshot.h"
+
+namespace {
+
+using binary_format::readBytes;
+using binary_format::readVarint;
+using binary_format::writeBytes;
+using binary_format::writeVarint;
+
+} // namespace
+
+// --- class ReplayIndex ---
+std::optional<std::string>
+ReplayIndex::build(std::istream &input, std::size_t events_per_checkpoint) {
+  checkpoints.clear();
+  if (events_per_checkpoint == 0) {
+    events_per_checkpoint = 1;
+  }
+
+  ClubConfig config;
+  std::optional<std::string> config_error =
+      loadClubConfiguration(input, config);
+  if (config_error.has_value()) {
+    return "invalid configuration line: " + config_error.value();
+  }
+  std::streamoff start = input.tellg();
+  if (start < 0) {
+    return "input is not seekable";
+  }
+
+  withClubEngine(config, [&](auto &club) {
+    Checkpoint checkpoint;
+    checkpoint.input_offset = static_cast<std::uint64_t>(start);
+    checkpoint.state = club_snapshot::encode(club.saveOccupancySnapshot());
+    checkpoints.push_back(checkpoint);
+
+    // only a rejected line is ever written, and replay stops there too
+    std::ostringstream rejected_line;
+    EventStreamState state;
+    std::string line;
+    while (std::getline(input, line)) {
+      checkpoint.input_offset += line.size() + 1;
+      if (line.empty()) {
+        continue;
+      }
+      if (!feedEventLine(club, line, state, rejected_line)) {
+        break;
+      }
+      if (++checkpoint.events_fed % events_per_checkpoint == 0) {
+        checkpoint.last_event_time = state.last_event_time;
+        checkpoint.first_event = state.first_event;
+        checkpoint.state = club_snapshot::encode(club.saveOccupancySnapshot());
+        checkpoints.push_back(checkpoint);
+      }
+    }
+  });
+  return std::nullopt;
+}
+
+const std::vector<ReplayIndex::Checkpoint> &
+ReplayIndex::getCheckpoints() const {
+  return checkpoints;
+}
+
+std::optional<std::string>
+ReplayIndex::stateAt(std::istream &input, const Time &time,
+                     ClubStateSnapshot &state) const {
+  if (checkpoints.empty()) {
+    return "replay index is empty";
+  }
+  // the initial checkpoint has no events, so it always qualifies
+  auto after = std::upper_bound(
+      checkpoints.begin() + 1, checkpoints.end(), time,
+      [](const Time &t, const Checkpoint &c) { return t < c.last_event_time; });
+  const Checkpoint &checkpoint = *(after - 1);
+
+  ClubStateSnapshot snapshot;
+  std::optional<std::string> error =
+      club_snapshot::decode(checkpoint.state, snapshot);
+  if (error.has_value()) {
+    return "invalid checkpoint: " + error.value();
+  }
+
+  input.clear();
+  input.seekg(static_cast<std::streamoff>(checkpoint.input_offset));
+  if (!input) {
+    return "cannot seek input to checkpoint";
+  }
+
+  withClubEngine(snapshot.config, [&](auto &club) {
+    club.restoreSnapshot(snapshot);
+    EventStreamState stream_state{checkpoint.last_event_time,
+                                  checkpoint.first_event};
+    std::ostringstream rejected_line;
+    std::string line;
+    while (std::getline(input, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      std::string time_str = line.substr(0, line.find(' '));
+      Time event_time;
+      if (Time::tryParse(time_str, event_time) == TimeParseStatus::OK &&
+          time < event_time) {
+        break;
+      }
+      if (!feedEventLine(club, line, stream_state, rejected_line)) {
+        break;
+      }
+    }
+    state = club.saveOccupancySnapshot();
+  });
+  return std::nullopt;
+}
+
+std::string ReplayIndex::serialize() const {
+  std::string out(kMagic, sizeof(kMagic));
+  out.push_back(static_cast<char>(kVersion));
+  writeVarint(out, checkpoints.size());
+  for (const Checkpoint &checkpoint : checkpoints) {
+    writeVarint(out, checkpoint.input_offset);
+    writeVarint(out, checkpoint.events_fed);
+    writeVarint(out, checkpoint.last_event_time.toMinutes());
+    out.push_back(static_cast<char>(checkpoint.first_event ? 1 : 0));
+    writeBytes(out, checkpoint.state);
+  }
+  return out;
+}
+
+std::optional<std::string> ReplayIndex::deserialize(const std::string &data) {
+  checkpoints.clear();
+  const std::uint8_t *cursor =
+      reinterpret_cast<const std::uint8_t *>(data.data());
+  const std::uint8_t *end = cursor + data.size();
+  if (data.size() < sizeof(kMagic) + 1 ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return "not a replay index";
+  }
+  cursor += sizeof(kMagic);
+  if (*cursor++ != kVersion) {
+    return "unsupported replay index version";
+  }
+
+  std::uint64_t count;
+  if (!readVarint(cursor, end, count) ||
+      count > static_cast<std::uint64_t>(end - cursor)) {
+    return "truncated replay index";
+  }
+  checkpoints.resize(count);
+  for (Checkpoint &checkpoint : checkpoints) {
+    std::uint64_t minutes;
+    if (!readVarint(cursor, end, checkpoint.input_offset) ||
+        !readVarint(cursor, end, checkpoint.events_fed) ||
+        !readVarint(cursor, end, minutes) || cursor == end) {
+      checkpoints.clear();
+      return "truncated checkpoint";
+    }
+    std::uint8_t first_event = *cursor++;
+    if (minutes >= 24 * 60 || first_event > 1 ||
+        !readBytes(cursor, end, checkpoint.state)) {
+      checkpoints.clear();
+      return "invalid checkpoint";
+    }
+    checkpoint.last_event_time = Time(static_cast<int>(minutes));
+    checkpoint.first_event = first_event == 1;
+  }
+  if (cursor != end) {
+    checkpoints.clear();
+    return "trailing bytes after replay index";
+  }
+  return std::nullopt;
+}
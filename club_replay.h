@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "computer_club.h"
+
+// Checkpoints of a text input taken every K events, so the state of the
+// club at any time of the day is restored from the nearest checkpoint and
+// at most K more input lines, whatever the length of the day. Checkpoints
+// hold the occupancy only (saveOccupancySnapshot), so each one is as large
+// as the club's current state and the index grows linearly with the day.
+//
+// Persisted layout (version 1, LEB128 varints unless noted):
+//   "CCRI" magic, u8 version, checkpoint count, then per checkpoint:
+//   input offset, events fed, last event minutes, u8 first-event flag,
+//   length + club_snapshot image
+class ReplayIndex {
+public:
+  static constexpr char kMagic[4] = {'C', 'C', 'R', 'I'};
+  static constexpr std::uint8_t kVersion = 1;
+  static constexpr std::size_t kDefaultEventsPerCheckpoint = 1024;
+
+  struct Checkpoint {
+    // first byte of the input after the last fed line
+    std::uint64_t input_offset = 0;
+    std::uint64_t events_fed = 0;
+    Time last_event_time;
+    bool first_event = true;
+    std::string state; // club_snapshot::encode of the club's occupancy
+  };
+
+private:
+  std::vector<Checkpoint> checkpoints;
+
+public:
+  // Reads a whole text input from its current position to the first
+  // rejected line. Fails only on a rejected configuration.
+  std::optional<std::string>
+  build(std::istream &input,
+        std::size_t events_per_checkpoint = kDefaultEventsPerCheckpoint);
+
+  const std::vector<Checkpoint> &getCheckpoints() const;
+
+  // Occupancy after every event at or before time, end of day not applied;
+  // table totals and bills are not part of it.
+  // input is the text the index was built from and must be seekable.
+  std::optional<std::string> stateAt(std::istream &input, const Time &time,
+                                     ClubStateSnapshot &state) const;
+
+  std::string serialize() const;
+  // returns error description on malformed data
+  std::optional<std::string> deserialize(const std::string &data);
+};
@@ -0,0 +1,101 @@
+#include "club_rollup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+#include "binary_format.h"
+#include "club_runner.h"
+#include "club_trace.h"
+
+std::optional<TableStatsSummary> summarizeDayFile(const std::string &path) {
+  bool is_binary = binary_format::isBinaryEventFile(path);
+  std::ios::openmode mode =
+      is_binary ? std::ios::in | std::ios::binary : std::ios::in;
+  std::ifstream input_file(path, mode);
+  if (!input_file.is_open()) {
+    return std::nullopt;
+  }
+  return is_binary ? summarizeBinaryInput(input_file)
+                   : summarizeTextInput(input_file);
+}
+
+RollupResult rollupDayFiles(const std::vector<std::string> &paths,
+                            unsigned num_threads, Tracer *tracer) {
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (paths.size() < num_threads) {
+    num_threads = std::max<unsigned>(1, static_cast<unsigned>(paths.size()));
+  }
+
+  // every worker folds the days it takes into its own partial sum, so the
+  // memory held is one summary per worker rather than one per day
+  std::vector<TableStatsSummary> partials(num_threads);
+  std::vector<std::vector<std::size_t>> skipped(num_threads);
+  std::atomic<std::size_t> next_path{0};
+
+  auto work = [&](unsigned worker) {
+    for (std::size_t i = next_path.fetch_add(1); i < paths.size();
+         i = next_path.fetch_add(1)) {
+      TraceScope span(tracer, "summarize day");
+      std::optional<TableStatsSummary> day = summarizeDayFile(paths[i]);
+      if (day.has_value()) {
+        partials[worker].merge(day.value());
+      } else {
+        skipped[worker].push_back(i);
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned worker = 1; worker < num_threads; ++worker) {
+    workers.emplace_back(work, worker);
+  }
+  work(0);
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  // tree reduction: at each level partial i absorbs partial i + stride
+  for (std::size_t stride = 1; stride < partials.size(); stride *= 2) {
+    std::vector<std::thread> mergers;
+    for (std::size_t i = 0; i + stride < partials.size(); i += 2 * stride) {
+      mergers.emplace_back([&partials, i, stride, tracer] {
+        TraceScope span(tracer, "merge");
+        partials[i].merge(partials[i + stride]);
+      });
+    }
+    for (std::thread &merger : mergers) {
+      merger.join();
+    }
+  }
+
+  RollupResult result;
+  result.totals = std::move(partials[0]);
+  std::vector<std::size_t> skipped_indices;
+  for (const std::vector<std::size_t> &worker_skipped : skipped) {
+    skipped_indices.insert(skipped_indices.end(), worker_skipped.begin(),
+                           worker_skipped.end());
+  }
+  std::sort(skipped_indices.begin(), skipped_indices.end());
+  for (std::size_t index : skipped_indices) {
+    result.skipped_files.push_back(paths[index]);
+  }
+  return result;
+}
+
+void writeRollupReport(const TableStatsSummary &totals, std::ostream &output) {
+  // totals of many days overflow Time, so hours are padded here; the
+  // caller's fill character is given back
+  char fill = output.fill('0');
+  for (int i = 0; i < totals.numTables(); ++i) {
+    output << (i + 1) << ' ' << totals.revenue[i] << ' ' << std::setw(2)
+           << totals.minutes_used[i] / 60 << ':' << std::setw(2)
+           << totals.minutes_used[i] % 60 << '\n';
+  }
+  output.fill(fill);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "computer_club.h"
+
+class Tracer;
+
+// Aggregation of table statistics over many day files (monthly reports).
+// Days are processed in parallel and their numeric totals are reduced
+// pairwise, the per-day text report is never produced.
+
+struct RollupResult {
+  TableStatsSummary totals;
+  // files that could not be opened or have no table statistics
+  std::vector<std::string> skipped_files;
+};
+
+// text or binary day file, picked by the binary magic like task does
+std::optional<TableStatsSummary> summarizeDayFile(const std::string &path);
+
+// num_threads 0 means std::thread::hardware_concurrency(); with a tracer
+// every day file and every merge is recorded as a span of its thread
+RollupResult rollupDayFiles(const std::vector<std::string> &paths,
+                            unsigned num_threads = 0,
+                            Tracer *tracer = nullptr);
+
+// one line per table: <id> <revenue> <HH:MM>, hours are not wrapped
+void writeRollupReport(const TableStatsSummary &totals, std::ostream &output);
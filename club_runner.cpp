@@ -0,0 +1,429 @@
+#include "club_runner.h"
+
+#include <iostream>
+#include <iterator>
+
+#include "binary_format.h"
+#include "club_memory.h"
+#include "club_metrics.h"
+#include "club_trace.h"
+
+namespace {
+
+// lines or records handled per read/parse/dispatch span of a traced run
+constexpr std::size_t kTraceBatchSize = 4096;
+
+// same acceptance rules as feedEventLine, nullopt for a rejected line
+std::optional<EventInput> parseStreamEvent(const std::string &event_line_str,
+                                           int num_tables,
+                                           EventStreamState &state) {
+  std::optional<EventInput> event = parseEventInput(event_line_str, num_tables);
+  if (!event.has_value() ||
+      (!state.first_event && event->time < state.last_event_time)) {
+    return std::nullopt;
+  }
+  state.last_event_time = event->time;
+  state.first_event = false;
+  return event;
+}
+
+template <typename Club>
+void dispatchTracedEvent(Club &club, Tracer &tracer, std::uint64_t &dispatched,
+                         const Time &time, int event_id,
+                         const std::string &client_name, int table_id,
+                         const RunOptions &options) {
+  std::uint32_t sample_interval = tracer.eventSampleInterval();
+  if (sample_interval != 0 && ++dispatched % sample_interval == 0) {
+    TraceScope span(&tracer, eventHandlerSpanName(event_id));
+    club.processEvent(time, event_id, client_name, table_id);
+  } else {
+    club.processEvent(time, event_id, client_name, table_id);
+  }
+  if (options.metrics != nullptr) {
+    options.metrics->publish(club, time);
+  }
+}
+
+template <typename Club>
+void finishTracedDay(Club &club, std::ostream &output,
+                     const RunOptions &options) {
+  Tracer *tracer = options.trace;
+  {
+    TraceScope span(tracer, "processEndOfDay");
+    club.processEndOfDay();
+  }
+  if (options.metrics != nullptr) {
+    options.metrics->finish(club);
+  }
+  std::vector<ClientBill> top_spenders;
+  {
+    TraceScope span(tracer, "statistics");
+    top_spenders = club.getTopSpenders(options.top_spenders);
+  }
+  TraceScope span(tracer, "write output");
+  for (const auto &logged_event : club.getEventLog()) {
+    output << logged_event.toString() << '\n';
+  }
+  output << club.getCloseTime().toString() << '\n';
+  club.writeTableStatistics(output);
+  writeTopSpenders(top_spenders, output);
+}
+
+template <typename Club>
+int runTracedTextEvents(Club &club, std::istream &input, std::ostream &output,
+                        const RunOptions &options) {
+  Tracer &tracer = *options.trace;
+  output << club.getOpenTime().toString() << '\n';
+
+  if (options.metrics != nullptr) {
+    options.metrics->setTableCount(club.getConfiguration().num_tables);
+  }
+  const int num_tables = club.getConfiguration().num_tables;
+  EventStreamState state;
+  std::vector<std::string> lines;
+  std::vector<EventInput> events;
+  std::uint64_t dispatched = 0;
+  bool end_of_input = false;
+  while (!end_of_input) {
+    // line buffers are kept between batches to reuse their capacity
+    std::size_t line_count = 0;
+    {
+      TraceScope span(&tracer, "read");
+      while (line_count < kTraceBatchSize) {
+        if (line_count == lines.size()) {
+          lines.emplace_back();
+        }
+        if (!std::getline(input, lines[line_count])) {
+          end_of_input = true;
+          break;
+        }
+        ++line_count;
+      }
+    }
+
+    events.clear();
+    const std::string *rejected_line = nullptr;
+    {
+      TraceScope span(&tracer, "parse");
+      for (std::size_t i = 0; i < line_count; ++i) {
+        if (lines[i].empty()) {
+          continue;
+        }
+        std::optional<EventInput> event =
+            parseStreamEvent(lines[i], num_tables, state);
+        if (!event.has_value()) {
+          rejected_line = &lines[i];
+          break;
+        }
+        events.push_back(std::move(event.value()));
+      }
+    }
+
+    {
+      TraceScope span(&tracer, "dispatch");
+      for (const EventInput &event : events) {
+        dispatchTracedEvent(club, tracer, dispatched, event.time, event.id,
+                            event.client_name, event.table_id, options);
+      }
+    }
+    if (rejected_line != nullptr) {
+      output << *rejected_line << '\n';
+      return 0;
+    }
+  }
+
+  finishTracedDay(club, output, options);
+  return 0;
+}
+
+template <typename Club>
+int runTracedBinaryEvents(Club &club, binary_format::Reader &reader,
+                          std::ostream &output, std::ostream &errors,
+                          const RunOptions &options) {
+  Tracer &tracer = *options.trace;
+  output << club.getOpenTime().toString() << '\n';
+
+  if (options.metrics != nullptr) {
+    options.metrics->setTableCount(club.getConfiguration().num_tables);
+  }
+  const std::vector<std::string> &names = reader.getDictionary();
+  std::vector<binary_format::Record> records(kTraceBatchSize);
+  std::optional<std::string> error;
+  std::uint64_t dispatched = 0;
+  bool end_of_records = false;
+  while (!end_of_records) {
+    // the whole file is already in memory, decoding is the parse stage
+    std::size_t record_count = 0;
+    const binary_format::Record *raw_line = nullptr;
+    {
+      TraceScope span(&tracer, "parse");
+      while (record_count < kTraceBatchSize) {
+        binary_format::Record &record = records[record_count];
+        if (!reader.next(record, error)) {
+          end_of_records = true;
+          break;
+        }
+        if (record.kind == binary_format::kRawLineRecord) {
+          raw_line = &record;
+          end_of_records = true;
+          break;
+        }
+        ++record_count;
+      }
+    }
+
+    {
+      TraceScope span(&tracer, "dispatch");
+      for (std::size_t i = 0; i < record_count; ++i) {
+        const binary_format::Record &record = records[i];
+        dispatchTracedEvent(club, tracer, dispatched, record.time, record.kind,
+                            names[record.client_index], record.table_id,
+                            options);
+      }
+    }
+    if (raw_line != nullptr) {
+      output << raw_line->raw_line << '\n';
+      return 0;
+    }
+  }
+  if (error.has_value()) {
+    errors << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+
+  finishTracedDay(club, output, options);
+  return 0;
+}
+
+template <typename Club>
+void recordMemoryReport(const Club &club, const RunOptions &options) {
+  if (options.memory_report == nullptr) {
+    return;
+  }
+  MemoryReport report = readMemoryUsage();
+  for (const Event &logged_event : club.getEventLog()) {
+    if (logged_event.event_id >= 1 && logged_event.event_id <= 4) {
+      ++report.events;
+    }
+  }
+  report.clients = club.getSeatedClientCount();
+  report.engine_object_bytes = sizeof(Club);
+  *options.memory_report = report;
+}
+
+template <typename Club>
+void recordDistributions(const Club &club, const RunOptions &options) {
+  if (options.distributions != nullptr) {
+    *options.distributions = club.getDistributions();
+  }
+  if (options.occupancy != nullptr) {
+    *options.occupancy = club.getOccupancyCurve();
+  }
+}
+
+template <typename Club>
+int runTextEvents(Club &club, std::istream &input, std::ostream &output,
+                  const RunOptions &options) {
+  if (options.trace != nullptr) {
+    return runTracedTextEvents(club, input, output, options);
+  }
+  output << club.getOpenTime().toString() << '\n';
+
+  if (options.metrics != nullptr) {
+    options.metrics->setTableCount(club.getConfiguration().num_tables);
+  }
+  EventStreamState state;
+  std::string event_line_str;
+  while (std::getline(input, event_line_str)) {
+    if (!feedEventLine(club, event_line_str, state, output)) {
+      return 0;
+    }
+    if (options.metrics != nullptr && !event_line_str.empty()) {
+      options.metrics->publish(club, state.last_event_time);
+    }
+  }
+
+  club.processEndOfDay();
+  if (options.metrics != nullptr) {
+    options.metrics->finish(club);
+  }
+  writeDayReport(club, output, options);
+  return 0;
+}
+
+template <typename Club>
+int runBinaryEvents(Club &club, binary_format::Reader &reader,
+                    std::ostream &output, std::ostream &errors,
+                    const RunOptions &options) {
+  if (options.trace != nullptr) {
+    return runTracedBinaryEvents(club, reader, output, errors, options);
+  }
+  output << club.getOpenTime().toString() << '\n';
+
+  if (options.metrics != nullptr) {
+    options.metrics->setTableCount(club.getConfiguration().num_tables);
+  }
+  // records are validated by the reader, so the text parser is skipped
+  const std::vector<std::string> &names = reader.getDictionary();
+  binary_format::Record record;
+  std::optional<std::string> error;
+  while (reader.next(record, error)) {
+    if (record.kind == binary_format::kRawLineRecord) {
+      output << record.raw_line << '\n';
+      return 0;
+    }
+    club.processEvent(record.time, record.kind, names[record.client_index],
+                      record.table_id);
+    if (options.metrics != nullptr) {
+      options.metrics->publish(club, record.time);
+    }
+  }
+  if (error.has_value()) {
+    errors << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+
+  club.processEndOfDay();
+  if (options.metrics != nullptr) {
+    options.metrics->finish(club);
+  }
+  writeDayReport(club, output, options);
+  return 0;
+}
+
+template <typename Club>
+std::optional<TableStatsSummary>
+summarizeBinaryEvents(Club &club, binary_format::Reader &reader) {
+  const std::vector<std::string> &names = reader.getDictionary();
+  binary_format::Record record;
+  std::optional<std::string> error;
+  while (reader.next(record, error)) {
+    if (record.kind == binary_format::kRawLineRecord) {
+      return std::nullopt;
+    }
+    club.processEvent(record.time, record.kind, names[record.client_index],
+                      record.table_id);
+  }
+  if (error.has_value()) {
+    return std::nullopt;
+  }
+  club.processEndOfDay();
+  return club.getTableTotals();
+}
+
+template <typename Club>
+bool feedWholeDay(Club &club, std::istream &input) {
+  // only a rejected line is ever written, and then the day is dropped
+  std::ostringstream rejected_line;
+  EventStreamState state;
+  std::string event_line_str;
+  while (std::getline(input, event_line_str)) {
+    if (!feedEventLine(club, event_line_str, state, rejected_line)) {
+      return false;
+    }
+  }
+  club.processEndOfDay();
+  return true;
+}
+
+} // namespace
+
+int runTextInput(std::istream &input, std::ostream &output,
+                 const RunOptions &options) {
+  ClubConfig config;
+  std::optional<std::string> config_error_line;
+  {
+    TraceScope span(options.trace, "load config");
+    config_error_line = loadClubConfiguration(input, config);
+  }
+
+  if (config_error_line.has_value()) {
+    output << config_error_line.value() << '\n';
+    return 0;
+  }
+
+  return withClubEngine(config, [&](auto &club) {
+    int exit_code = runTextEvents(club, input, output, options);
+    recordMemoryReport(club, options);
+    recordDistributions(club, options);
+    return exit_code;
+  });
+}
+
+int runBinaryInput(std::istream &input, std::ostream &output,
+                   std::ostream &errors, const RunOptions &options) {
+  std::string data;
+  {
+    TraceScope span(options.trace, "read");
+    data.assign(std::istreambuf_iterator<char>(input),
+                std::istreambuf_iterator<char>());
+  }
+
+  binary_format::Reader reader;
+  std::optional<std::string> error;
+  {
+    TraceScope span(options.trace, "load config");
+    error = reader.open(data);
+  }
+  if (error.has_value()) {
+    errors << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+
+  return withClubEngine(reader.getConfiguration(), [&](auto &club) {
+    int exit_code = runBinaryEvents(club, reader, output, errors, options);
+    recordMemoryReport(club, options);
+    recordDistributions(club, options);
+    return exit_code;
+  });
+}
+
+std::optional<TableStatsSummary> summarizeTextInput(std::istream &input) {
+  ClubConfig config;
+  if (loadClubConfiguration(input, config).has_value()) {
+    return std::nullopt;
+  }
+  return withClubEngine(
+      config, [&](auto &club) -> std::optional<TableStatsSummary> {
+        if (!feedWholeDay(club, input)) {
+          return std::nullopt;
+        }
+        return club.getTableTotals();
+      });
+}
+
+std::optional<TableStatsSummary> summarizeBinaryInput(std::istream &input) {
+  std::string data((std::istreambuf_iterator<char>(input)),
+                   std::istreambuf_iterator<char>());
+
+  binary_format::Reader reader;
+  if (reader.open(data).has_value()) {
+    return std::nullopt;
+  }
+  return withClubEngine(reader.getConfiguration(), [&](auto &club) {
+    return summarizeBinaryEvents(club, reader);
+  });
+}
+
+std::optional<std::vector<Event>> collectEventLog(std::istream &input) {
+  ClubConfig config;
+  if (loadClubConfiguration(input, config).has_value()) {
+    return std::nullopt;
+  }
+  return withClubEngine(
+      config, [&](auto &club) -> std::optional<std::vector<Event>> {
+        if (!feedWholeDay(club, input)) {
+          return std::nullopt;
+        }
+        return club.getEventLog();
+      });
+}
+
+void writeTopSpenders(const std::vector<ClientBill> &top_spenders,
+                      std::ostream &output) {
+  for (const ClientBill &bill : top_spenders) {
+    output << bill.client_name << ' ' << bill.revenue << ' '
+           << Time(static_cast<int>(bill.minutes)).toString() << ' '
+           << bill.billed_hours << ' ' << bill.sessions << '\n';
+  }
+}
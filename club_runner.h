@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "computer_club.h"
+
+class MetricsWriter;
+class Tracer;
+struct MemoryReport;
+
+// --- optional outputs of a run, all off by default ---
+struct RunOptions {
+  // clients with the highest spend, listed after the table statistics as
+  // <name> <revenue> <HH:MM> <billed hours> <sessions>; 0 lists none
+  std::size_t top_spenders = 0;
+  // live metrics published after every event, see club_metrics.h
+  MetricsWriter *metrics = nullptr;
+  // spans of the processing stages, see club_trace.h; events are then read
+  // and dispatched in batches so that each stage gets its own span
+  Tracer *trace = nullptr;
+  // heap usage per subsystem, taken at the end of the run while the engine
+  // is still alive; needs enableMemoryAccounting(), see club_memory.h
+  MemoryReport *memory_report = nullptr;
+  // session length and queue wait distributions of the day, also of a day
+  // stopped by a rejected line; see club_histogram.h
+  ClubDistributions *distributions = nullptr;
+  // occupied tables and queue length per working minute, filled like
+  // distributions; see club_timeline.h
+  OccupancyCurve *occupancy = nullptr;
+};
+
+// Runs a whole input and prints the report in the task output format.
+// Engine variant is picked from the table count, see withClubEngine.
+// Return value is the process exit code.
+int runTextInput(std::istream &input, std::ostream &output,
+                 const RunOptions &options = {});
+int runBinaryInput(std::istream &input, std::ostream &output,
+                   std::ostream &errors, const RunOptions &options = {});
+
+// Runs a whole input and returns the table totals instead of a report.
+// nullopt when the day stops early (rejected line, malformed binary file),
+// the cases in which the report above has no table statistics.
+std::optional<TableStatsSummary> summarizeTextInput(std::istream &input);
+std::optional<TableStatsSummary> summarizeBinaryInput(std::istream &input);
+// event log of a whole text input, nullopt when the day stops early
+std::optional<std::vector<Event>> collectEventLog(std::istream &input);
+
+// --- per-line driving shared by all input front-ends ---
+struct EventStreamState {
+  Time last_event_time;
+  bool first_event = true;
+};
+
+// Feeds one event line. Returns false when processing must stop; the
+// offending line has then already been written to output.
+template <typename Club>
+bool feedEventLine(Club &club, const std::string &event_line_str,
+                   EventStreamState &state, std::ostream &output) {
+  if (event_line_str.empty()) {
+    return true;
+  }
+  std::string time_str_from_event;
+  std::istringstream iss_event_peek(event_line_str);
+  iss_event_peek >> time_str_from_event;
+
+  Time current_event_time;
+  if (Time::tryParse(time_str_from_event, current_event_time) !=
+      TimeParseStatus::OK) {
+    // Ошибка формата времени в строке события
+    output << event_line_str << '\n';
+    return false;
+  }
+
+  if (!state.first_event && current_event_time < state.last_event_time) {
+    // Нарушение последовательности времени событий
+    output << event_line_str << '\n';
+    return false;
+  }
+
+  std::optional<std::string> event_format_error =
+      club.processEventLine(event_line_str);
+
+  if (event_format_error.has_value()) {
+    output << event_format_error.value() << '\n';
+    return false;
+  }
+
+  state.last_event_time = current_event_time;
+  state.first_event = false;
+  return true;
+}
+
+// report lines after the table statistics
+void writeTopSpenders(const std::vector<ClientBill> &top_spenders,
+                      std::ostream &output);
+
+// report lines after the closing time
+template <typename Club>
+void writeReportTail(const Club &club, std::size_t top_spenders,
+                     std::ostream &output) {
+  club.writeTableStatistics(output);
+  writeTopSpenders(club.getTopSpenders(top_spenders), output);
+}
+
+template <typename Club>
+void writeDayReport(const Club &club, std::ostream &output,
+                    const RunOptions &options = {}) {
+  for (const auto &logged_event : club.getEventLog()) {
+    output << logged_event.toString() << '\n';
+  }
+
+  output << club.getCloseTime().toString() << '\n';
+
+  writeReportTail(club, options.top_spenders, output);
+}
@@ -0,0 +1,313 @@
+#include "club_scheduler.h"
+
+#include <algorithm>
+#include <exception>
+#include <ostream>
+#include <sstream>
+#include <utility>
+#include <variant>
+
+#include "club_runner.h"
+#include "computer_club.h"
+
+#ifdef CLUB_HAS_FD_SOURCES
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// --- class LineSource ---
+void LineSource::notifyReadable() {
+  if (parked_scheduler != nullptr) {
+    retryParked();
+  }
+}
+
+bool LineSource::retryParked() {
+  Status status = tryGetLine(*parked_line);
+  if (status == Status::PENDING) {
+    return false;
+  }
+  *parked_status = status;
+  ClubScheduler *scheduler = parked_scheduler;
+  std::coroutine_handle<> club = parked_club;
+  parked_scheduler = nullptr;
+  parked_club = nullptr;
+  parked_line = nullptr;
+  parked_status = nullptr;
+  scheduler->makeReady(club);
+  return true;
+}
+
+// --- class MemoryLineSource ---
+MemoryLineSource::MemoryLineSource(std::size_t max_buffered_lines)
+    : capacity(max_buffered_lines) {}
+
+bool MemoryLineSource::push(std::string line) {
+  if (lines.size() >= capacity) {
+    return false;
+  }
+  lines.push_back(std::move(line));
+  notifyReadable();
+  return true;
+}
+
+void MemoryLineSource::close() {
+  closed = true;
+  notifyReadable();
+}
+
+std::size_t MemoryLineSource::buffered() const { return lines.size(); }
+
+LineSource::Status MemoryLineSource::tryGetLine(std::string &line) {
+  if (!lines.empty()) {
+    line = std::move(lines.front());
+    lines.pop_front();
+    return Status::LINE;
+  }
+  return closed ? Status::END : Status::PENDING;
+}
+
+#ifdef CLUB_HAS_FD_SOURCES
+// --- class FdLineSource ---
+FdLineSource::FdLineSource(int fd, std::size_t buffer_size)
+    : fd(fd), buffer(buffer_size) {
+  int flags = fcntl(fd, F_GETFL);
+  if (flags != -1) {
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+  }
+}
+
+FdLineSource::~FdLineSource() { ::close(fd); }
+
+LineSource::Status FdLineSource::tryGetLine(std::string &line) {
+  while (true) {
+    const char *first = buffer.data() + begin;
+    const char *last = buffer.data() + end;
+    const char *newline = std::find(first, last, '\n');
+    if (newline != last) {
+      partial_line.append(first, newline);
+      line.swap(partial_line);
+      partial_line.clear();
+      begin += (newline - first) + 1;
+      return Status::LINE;
+    }
+    partial_line.append(first, last);
+    begin = end = 0;
+
+    if (eof) {
+      if (partial_line.empty()) {
+        return Status::END;
+      }
+      line.swap(partial_line);
+      partial_line.clear();
+      return Status::LINE;
+    }
+
+    ssize_t n = ::read(fd, buffer.data(), buffer.size());
+    if (n > 0) {
+      end = static_cast<std::size_t>(n);
+    } else if (n == 0) {
+      eof = true;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return Status::PENDING;
+    } else if (errno != EINTR) {
+      eof = true;
+    }
+  }
+}
+
+int FdLineSource::waitDescriptor() const { return fd; }
+#endif
+
+// --- class ClubTask ---
+ClubTask ClubTask::promise_type::get_return_object() {
+  return ClubTask(Handle::from_promise(*this));
+}
+
+void ClubTask::promise_type::unhandled_exception() { std::terminate(); }
+
+ClubTask::ClubTask(Handle h) : coroutine(h) {}
+
+ClubTask::ClubTask(ClubTask &&other) noexcept
+    : coroutine(std::exchange(other.coroutine, nullptr)) {}
+
+ClubTask &ClubTask::operator=(ClubTask &&other) noexcept {
+  if (this != &other) {
+    if (coroutine) {
+      coroutine.destroy();
+    }
+    coroutine = std::exchange(other.coroutine, nullptr);
+  }
+  return *this;
+}
+
+ClubTask::~ClubTask() {
+  if (coroutine) {
+    coroutine.destroy();
+  }
+}
+
+bool ClubTask::done() const { return coroutine.done(); }
+
+int ClubTask::exitCode() const { return coroutine.promise().exit_code; }
+
+ClubTask::Handle ClubTask::handle() const { return coroutine; }
+
+// --- class ClubScheduler ---
+bool ClubScheduler::LineAwaiter::await_ready() {
+  status = source.tryGetLine(line);
+  return status != LineSource::Status::PENDING;
+}
+
+void ClubScheduler::LineAwaiter::await_suspend(
+    std::coroutine_handle<> club) {
+  scheduler.park(source, club, line, status);
+}
+
+bool ClubScheduler::LineAwaiter::await_resume() {
+  return status == LineSource::Status::LINE;
+}
+
+void ClubScheduler::YieldAwaiter::await_suspend(
+    std::coroutine_handle<> club) {
+  scheduler.makeReady(club);
+}
+
+ClubScheduler::LineAwaiter ClubScheduler::nextLine(LineSource &source,
+                                                   std::string &line) {
+  return LineAwaiter{*this, source, line};
+}
+
+ClubScheduler::YieldAwaiter ClubScheduler::yield() {
+  return YieldAwaiter{*this};
+}
+
+void ClubScheduler::makeReady(std::coroutine_handle<> club) {
+  ready.push_back(club);
+}
+
+void ClubScheduler::park(LineSource &source, std::coroutine_handle<> club,
+                         std::string &line, LineSource::Status &status) {
+  source.parked_scheduler = this;
+  source.parked_club = club;
+  source.parked_line = &line;
+  source.parked_status = &status;
+  parked.push_back(&source);
+}
+
+bool ClubScheduler::waitForDescriptors() {
+#ifdef CLUB_HAS_FD_SOURCES
+  std::vector<pollfd> fds;
+  std::vector<LineSource *> waiting;
+  for (LineSource *source : parked) {
+    if (source->waitDescriptor() >= 0) {
+      fds.push_back(pollfd{source->waitDescriptor(), POLLIN, 0});
+      waiting.push_back(source);
+    }
+  }
+  while (!fds.empty()) {
+    if (::poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bool woke_any = false;
+    for (std::size_t i = 0; i < fds.size(); ++i) {
+      if (fds[i].revents != 0 && waiting[i]->retryParked()) {
+        woke_any = true;
+      }
+    }
+    if (woke_any) {
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+std::size_t ClubScheduler::spawn(ClubTask task) {
+  ready.push_back(task.handle());
+  tasks.push_back(std::move(task));
+  return tasks.size() - 1;
+}
+
+const ClubTask &ClubScheduler::task(std::size_t index) const {
+  return tasks[index];
+}
+
+bool ClubScheduler::run() {
+  while (true) {
+    while (!ready.empty()) {
+      std::coroutine_handle<> club = ready.front();
+      ready.pop_front();
+      ++resumes;
+      club.resume();
+    }
+    parked.erase(std::remove_if(parked.begin(), parked.end(),
+                                [](const LineSource *source) {
+                                  return source->parked_scheduler == nullptr;
+                                }),
+                 parked.end());
+    if (parked.empty() || !waitForDescriptors()) {
+      break;
+    }
+  }
+  return std::all_of(tasks.begin(), tasks.end(),
+                     [](const ClubTask &task) { return task.done(); });
+}
+
+std::uint64_t ClubScheduler::resumeCount() const { return resumes; }
+
+ClubTask runClubStream(ClubScheduler &scheduler, LineSource &source,
+                       std::ostream &output) {
+  // configuration is parsed from the same three lines a file would give
+  std::string config_text;
+  std::string line;
+  for (int i = 0; i < 3; ++i) {
+    if (!co_await scheduler.nextLine(source, line)) {
+      break;
+    }
+    config_text += line;
+    config_text += '\n';
+  }
+  std::istringstream config_stream(config_text);
+  ClubConfig config;
+  std::optional<std::string> config_error_line =
+      loadClubConfiguration(config_stream, config);
+  if (config_error_line.has_value()) {
+    output << config_error_line.value() << '\n';
+    co_return 0;
+  }
+
+  AnyComputerClub club;
+  emplaceClubEngine(club, config);
+  output << config.open_time.toString() << '\n';
+
+  EventStreamState state;
+  int lines_in_slice = 0;
+  while (co_await scheduler.nextLine(source, line)) {
+    bool keep_going = std::visit(
+        [&](auto &engine) {
+          return feedEventLine(engine, line, state, output);
+        },
+        club);
+    if (!keep_going) {
+      co_return 0;
+    }
+    if (++lines_in_slice == ClubScheduler::kLinesPerSlice) {
+      lines_in_slice = 0;
+      co_await scheduler.yield();
+    }
+  }
+
+  std::visit(
+      [&output](auto &engine) {
+        engine.processEndOfDay();
+        writeDayReport(engine, output);
+      },
+      club);
+  co_return 0;
+}
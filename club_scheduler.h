@@ -0,0 +1,173 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Cooperative driver for many club input streams on one thread. Each club
+// is a coroutine that awaits lines from its own LineSource; the scheduler
+// resumes whichever club has input and parks the others.
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CLUB_HAS_FD_SOURCES 1
+#endif
+
+class ClubScheduler;
+
+// --- source of input lines for one club ---
+class LineSource {
+public:
+  enum class Status { LINE, PENDING, END };
+
+  virtual ~LineSource() = default;
+
+  // non-blocking: PENDING means no complete line is buffered yet
+  virtual Status tryGetLine(std::string &line) = 0;
+  // descriptor to wait on while PENDING, -1 if readiness is pushed
+  virtual int waitDescriptor() const { return -1; }
+
+protected:
+  // retries the line read of the club parked on this source, if any
+  void notifyReadable();
+
+private:
+  friend class ClubScheduler;
+  ClubScheduler *parked_scheduler = nullptr;
+  std::coroutine_handle<> parked_club;
+  std::string *parked_line = nullptr;
+  Status *parked_status = nullptr;
+
+  // true if the parked club got a line or end of input and was woken
+  bool retryParked();
+};
+
+// bounded line buffer filled by the caller
+class MemoryLineSource : public LineSource {
+private:
+  std::deque<std::string> lines;
+  std::size_t capacity;
+  bool closed = false;
+
+public:
+  explicit MemoryLineSource(std::size_t max_buffered_lines = 64);
+
+  // false when the buffer is full; run the scheduler and retry
+  bool push(std::string line);
+  void close();
+  std::size_t buffered() const;
+
+  Status tryGetLine(std::string &line) override;
+};
+
+#ifdef CLUB_HAS_FD_SOURCES
+// lines read from a pipe or socket in non-blocking mode
+class FdLineSource : public LineSource {
+private:
+  int fd;
+  std::vector<char> buffer;
+  std::size_t begin = 0;
+  std::size_t end = 0;
+  std::string partial_line;
+  bool eof = false;
+
+public:
+  // takes ownership of fd and switches it to non-blocking mode
+  explicit FdLineSource(int fd, std::size_t buffer_size = 64 * 1024);
+  ~FdLineSource() override;
+  FdLineSource(const FdLineSource &) = delete;
+  FdLineSource &operator=(const FdLineSource &) = delete;
+
+  Status tryGetLine(std::string &line) override;
+  int waitDescriptor() const override;
+};
+#endif
+
+// --- coroutine of one club, owned by the scheduler ---
+class ClubTask {
+public:
+  struct promise_type {
+    int exit_code = 0;
+
+    ClubTask get_return_object();
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(int code) { exit_code = code; }
+    void unhandled_exception();
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit ClubTask(Handle h);
+  ClubTask(ClubTask &&other) noexcept;
+  ClubTask &operator=(ClubTask &&other) noexcept;
+  ClubTask(const ClubTask &) = delete;
+  ClubTask &operator=(const ClubTask &) = delete;
+  ~ClubTask();
+
+  bool done() const;
+  int exitCode() const;
+  Handle handle() const;
+
+private:
+  Handle coroutine;
+};
+
+class ClubScheduler {
+private:
+  std::deque<std::coroutine_handle<>> ready;
+  std::vector<LineSource *> parked;
+  std::vector<ClubTask> tasks;
+  std::uint64_t resumes = 0;
+
+  friend class LineSource;
+  void makeReady(std::coroutine_handle<> club);
+  void park(LineSource &source, std::coroutine_handle<> club,
+            std::string &line, LineSource::Status &status);
+  bool waitForDescriptors();
+
+public:
+  // lines a club may process before it yields to the others
+  static constexpr int kLinesPerSlice = 32;
+
+  struct LineAwaiter {
+    ClubScheduler &scheduler;
+    LineSource &source;
+    std::string &line;
+    LineSource::Status status = LineSource::Status::PENDING;
+
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> club);
+    // false at end of input
+    bool await_resume();
+  };
+
+  struct YieldAwaiter {
+    ClubScheduler &scheduler;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> club);
+    void await_resume() const noexcept {}
+  };
+
+  LineAwaiter nextLine(LineSource &source, std::string &line);
+  YieldAwaiter yield();
+
+  // returns index of the task, usable with task()
+  std::size_t spawn(ClubTask task);
+  const ClubTask &task(std::size_t index) const;
+
+  // Runs until every club is done or all remaining clubs wait on memory
+  // sources that need more input. Returns true if all clubs are done.
+  bool run();
+
+  std::uint64_t resumeCount() const;
+};
+
+// Reads the configuration and events of one club from source and writes
+// the report to output, with the same semantics as runTextInput.
+ClubTask runClubStream(ClubScheduler &scheduler, LineSource &source,
+                       std::ostream &output);
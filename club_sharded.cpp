@@ -0,0 +1,197 @@
+#include "club_sharded.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "club_scheduler.h"
+
+namespace {
+
+// lines routed to a worker in one hand-off
+constexpr std::size_t kShardBatchSize = 1024;
+// batches waiting per worker before the reader blocks
+constexpr std::size_t kMaxQueuedBatches = 8;
+// lines buffered per club before its coroutine must run
+constexpr std::size_t kClubLineBuffer = 256;
+
+struct ShardLine {
+  std::string club_id;
+  std::string line;
+};
+
+using ShardBatch = std::vector<ShardLine>;
+
+// bounded queue of batches from the reader to one worker
+class ShardInbox {
+private:
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<ShardBatch> batches;
+  bool closed = false;
+
+public:
+  void push(ShardBatch batch) {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return batches.size() < kMaxQueuedBatches; });
+    batches.push_back(std::move(batch));
+    changed.notify_all();
+  }
+  void close() {
+    std::lock_guard lock(mutex);
+    closed = true;
+    changed.notify_all();
+  }
+  // false once the inbox is closed and drained
+  bool pop(ShardBatch &batch) {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return !batches.empty() || closed; });
+    if (batches.empty()) {
+      return false;
+    }
+    batch = std::move(batches.front());
+    batches.pop_front();
+    changed.notify_all();
+    return true;
+  }
+};
+
+struct ClubShard {
+  MemoryLineSource source{kClubLineBuffer};
+  std::ostringstream output;
+  std::size_t task_index = 0;
+};
+
+// one thread; all clubs hashed to it live and run here
+class ShardWorker {
+private:
+  ClubScheduler scheduler;
+  std::unordered_map<std::string, std::unique_ptr<ClubShard>> clubs;
+  // first-seen order, so reports are handed out deterministically
+  std::vector<std::string> club_order;
+
+  ClubShard &club(const std::string &club_id) {
+    std::unique_ptr<ClubShard> &shard = clubs[club_id];
+    if (shard == nullptr) {
+      shard = std::make_unique<ClubShard>();
+      shard->task_index = scheduler.spawn(
+          runClubStream(scheduler, shard->source, shard->output));
+      club_order.push_back(club_id);
+    }
+    return *shard;
+  }
+
+public:
+  void feed(ShardBatch &batch) {
+    for (ShardLine &shard_line : batch) {
+      ClubShard &shard = club(shard_line.club_id);
+      // a club stopped by a rejected line ignores the rest of its lines
+      if (scheduler.task(shard.task_index).done()) {
+        continue;
+      }
+      if (shard.source.buffered() >= kClubLineBuffer) {
+        scheduler.run();
+        if (scheduler.task(shard.task_index).done()) {
+          continue;
+        }
+      }
+      shard.source.push(std::move(shard_line.line));
+    }
+    scheduler.run();
+  }
+
+  void finish(const ClubReportSink &sink, ShardedRunResult &result) {
+    for (auto &[club_id, shard] : clubs) {
+      shard->source.close();
+    }
+    scheduler.run();
+    result.clubs = club_order.size();
+    for (const std::string &club_id : club_order) {
+      if (!sink(club_id, clubs[club_id]->output.str())) {
+        result.failed_clubs.push_back(club_id);
+      }
+    }
+  }
+};
+
+} // namespace
+
+bool isValidClubId(std::string_view club_id) {
+  return !club_id.empty() && club_id.size() <= kMaxClubIdLength &&
+         std::all_of(club_id.begin(), club_id.end(), [](char c) {
+           return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                  (c >= '0' && c <= '9') || c == '_' || c == '-';
+         });
+}
+
+ShardedRunResult runShardedInput(std::istream &input, unsigned num_workers,
+                                 const ClubReportSink &sink) {
+  if (num_workers == 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::vector<ShardInbox> inboxes(num_workers);
+  std::vector<ShardedRunResult> worker_results(num_workers);
+  std::vector<std::thread> workers;
+  for (unsigned worker = 0; worker < num_workers; ++worker) {
+    workers.emplace_back([&, worker] {
+      ShardWorker shard_worker;
+      ShardBatch batch;
+      while (inboxes[worker].pop(batch)) {
+        shard_worker.feed(batch);
+      }
+      shard_worker.finish(sink, worker_results[worker]);
+    });
+  }
+
+  ShardedRunResult result;
+  std::vector<ShardBatch> pending(num_workers);
+  std::hash<std::string_view> hash_club;
+  std::string raw_line;
+  std::size_t line_number = 0;
+  while (std::getline(input, raw_line)) {
+    ++line_number;
+    if (raw_line.empty()) {
+      continue;
+    }
+    std::size_t space = raw_line.find(' ');
+    std::string_view club_id = std::string_view(raw_line).substr(0, space);
+    if (!isValidClubId(club_id)) {
+      result.invalid_lines.push_back(line_number);
+      continue;
+    }
+    unsigned worker = static_cast<unsigned>(hash_club(club_id) % num_workers);
+    std::string line =
+        space == std::string::npos ? std::string() : raw_line.substr(space + 1);
+    pending[worker].push_back({std::string(club_id), std::move(line)});
+    if (pending[worker].size() == kShardBatchSize) {
+      inboxes[worker].push(std::move(pending[worker]));
+      pending[worker] = ShardBatch();
+      pending[worker].reserve(kShardBatchSize);
+    }
+  }
+  for (unsigned worker = 0; worker < num_workers; ++worker) {
+    if (!pending[worker].empty()) {
+      inboxes[worker].push(std::move(pending[worker]));
+    }
+    inboxes[worker].close();
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  for (const ShardedRunResult &worker_result : worker_results) {
+    result.clubs += worker_result.clubs;
+    result.failed_clubs.insert(result.failed_clubs.end(),
+                               worker_result.failed_clubs.begin(),
+                               worker_result.failed_clubs.end());
+  }
+  std::sort(result.failed_clubs.begin(), result.failed_clubs.end());
+  return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Interleaved input of many clubs. Every line starts with a club id and a
+// space, the rest of the line belongs to that club:
+//   <club id> <line of the club's own input>
+// The lines of one club, in stream order, form an ordinary task input:
+// three configuration lines, then events. Club ids are 1 to 64 characters
+// from [A-Za-z0-9_-], so they can be used as file names. Empty lines are
+// ignored.
+//
+// Clubs are hash-partitioned over worker threads. A worker owns the
+// engines of its clubs and drives them with its own ClubScheduler, so club
+// state is never shared; only line batches cross threads. Each club keeps
+// its own configuration errors, rejected lines and time order check, and
+// its report equals that of task on the club's lines alone.
+
+constexpr std::size_t kMaxClubIdLength = 64;
+
+bool isValidClubId(std::string_view club_id);
+
+// Called once per club, from the worker owning it, when the input ends.
+// Returns false if the report could not be stored.
+using ClubReportSink =
+    std::function<bool(const std::string &club_id, const std::string &report)>;
+
+struct ShardedRunResult {
+  std::size_t clubs = 0;
+  // 1-based numbers of lines without a valid club id, skipped
+  std::vector<std::size_t> invalid_lines;
+  // clubs whose report the sink did not accept
+  std::vector<std::string> failed_clubs;
+};
+
+// num_workers 0 means std::thread::hardware_concurrency(); sink must be
+// safe to call from several workers at once
+ShardedRunResult runShardedInput(std::istream &input, unsigned num_workers,
+                                 const ClubReportSink &sink);
@@ -0,0 +1,224 @@
+#include "club_snapshot.h"
+
+#include <cstring>
+#include <limits>
+
+#include "binary_format.h"
+#include "event_archive.h"
+
+namespace club_snapshot {
+namespace {
+
+using binary_format::readBytes;
+using binary_format::readVarint;
+using binary_format::writeBytes;
+using binary_format::writeVarint;
+
+constexpr std::uint64_t kMaxInt = std::numeric_limits<int>::max();
+constexpr std::uint64_t kMinutesPerDay = 24 * 60;
+
+// reads a varint that must not exceed max_value
+bool readBounded(const std::uint8_t *&cursor, const std::uint8_t *end,
+                 std::uint64_t max_value, std::uint64_t &out) {
+  return readVarint(cursor, end, out) && out <= max_value;
+}
+
+bool readInt(const std::uint8_t *&cursor, const std::uint8_t *end,
+             int &out) {
+  std::uint64_t value;
+  if (!readBounded(cursor, end, kMaxInt, value)) {
+    return false;
+  }
+  out = static_cast<int>(value);
+  return true;
+}
+
+bool readCount(const std::uint8_t *&cursor, const std::uint8_t *end,
+               std::uint64_t &count) {
+  // every entry takes at least one byte
+  return readBounded(cursor, end, static_cast<std::uint64_t>(end - cursor),
+                     count);
+}
+
+bool readClientName(const std::uint8_t *&cursor, const std::uint8_t *end,
+                    std::string &name) {
+  return readBytes(cursor, end, name) && utils::isValidClientName(name);
+}
+
+} // namespace
+
+std::string encode(const ClubStateSnapshot &snapshot) {
+  std::string out(kMagic, sizeof(kMagic));
+  out.push_back(static_cast<char>(kVersion));
+  writeVarint(out, snapshot.config.num_tables);
+  writeVarint(out, snapshot.config.open_time.toMinutes());
+  writeVarint(out, snapshot.config.close_time.toMinutes());
+  writeVarint(out, snapshot.config.hourly_rate);
+
+  writeVarint(out, snapshot.tables.size());
+  for (const ClubStateSnapshot::TableState &table : snapshot.tables) {
+    writeVarint(out, table.table_id);
+    writeVarint(out, table.minutes_used);
+    writeVarint(out, table.revenue);
+    writeBytes(out, table.client_name);
+    writeVarint(out, table.session_start.toMinutes());
+  }
+
+  writeVarint(out, snapshot.clients.size());
+  for (const ClubStateSnapshot::ClientState &client : snapshot.clients) {
+    writeBytes(out, client.client_name);
+    out.push_back(static_cast<char>(client.location));
+    writeVarint(out, client.table_id);
+  }
+
+  writeVarint(out, snapshot.waiting_queue.size());
+  for (const std::string &client_name : snapshot.waiting_queue) {
+    writeBytes(out, client_name);
+  }
+
+  writeVarint(out, snapshot.bills.size());
+  for (const ClientBill &bill : snapshot.bills) {
+    writeBytes(out, bill.client_name);
+    writeVarint(out, bill.sessions);
+    writeVarint(out, bill.billed_hours);
+    writeVarint(out, static_cast<std::uint64_t>(bill.minutes));
+    writeVarint(out, static_cast<std::uint64_t>(bill.revenue));
+  }
+
+  out.push_back(static_cast<char>(snapshot.has_event_log ? 1 : 0));
+  if (snapshot.has_event_log) {
+    writeBytes(out, event_archive::writeArchive(snapshot.event_log));
+  }
+  return out;
+}
+
+std::optional<std::string> decode(const std::string &data,
+                                  ClubStateSnapshot &snapshot) {
+  snapshot = ClubStateSnapshot();
+  const std::uint8_t *cursor =
+      reinterpret_cast<const std::uint8_t *>(data.data());
+  const std::uint8_t *end = cursor + data.size();
+  if (data.size() < sizeof(kMagic) + 1 ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return "not a club state snapshot";
+  }
+  cursor += sizeof(kMagic);
+  if (*cursor++ != kVersion) {
+    return "unsupported snapshot version";
+  }
+
+  ClubConfig &config = snapshot.config;
+  std::uint64_t open_minutes, close_minutes;
+  if (!readInt(cursor, end, config.num_tables) ||
+      !readBounded(cursor, end, kMinutesPerDay - 1, open_minutes) ||
+      !readBounded(cursor, end, kMinutesPerDay - 1, close_minutes) ||
+      !readInt(cursor, end, config.hourly_rate)) {
+    return "truncated configuration";
+  }
+  if (config.num_tables == 0 || config.hourly_rate == 0 ||
+      open_minutes >= close_minutes) {
+    return "invalid configuration";
+  }
+  config.open_time = Time(static_cast<int>(open_minutes));
+  config.close_time = Time(static_cast<int>(close_minutes));
+  std::uint64_t num_tables = static_cast<std::uint64_t>(config.num_tables);
+
+  std::uint64_t count;
+  if (!readCount(cursor, end, count)) {
+    return "truncated tables";
+  }
+  snapshot.tables.resize(count);
+  int previous_table = 0;
+  for (ClubStateSnapshot::TableState &table : snapshot.tables) {
+    std::uint64_t start;
+    if (!readInt(cursor, end, table.table_id) ||
+        !readInt(cursor, end, table.minutes_used) ||
+        !readInt(cursor, end, table.revenue) ||
+        !readBytes(cursor, end, table.client_name) ||
+        !readBounded(cursor, end, kMinutesPerDay - 1, start)) {
+      return "truncated tables";
+    }
+    if (table.table_id <= previous_table ||
+        static_cast<std::uint64_t>(table.table_id) > num_tables ||
+        (!table.client_name.empty() &&
+         !utils::isValidClientName(table.client_name))) {
+      return "invalid table state";
+    }
+    previous_table = table.table_id;
+    table.session_start = Time(static_cast<int>(start));
+  }
+
+  if (!readCount(cursor, end, count)) {
+    return "truncated clients";
+  }
+  snapshot.clients.resize(count);
+  for (ClubStateSnapshot::ClientState &client : snapshot.clients) {
+    if (!readClientName(cursor, end, client.client_name) || cursor == end) {
+      return "truncated clients";
+    }
+    std::uint8_t location = *cursor++;
+    if (location > static_cast<std::uint8_t>(ClientLocation::IN_QUEUE) ||
+        !readInt(cursor, end, client.table_id) ||
+        static_cast<std::uint64_t>(client.table_id) > num_tables) {
+      return "invalid client state";
+    }
+    client.location = static_cast<ClientLocation>(location);
+  }
+
+  // the queue never holds more clients than there are tables
+  if (!readCount(cursor, end, count) || count > num_tables) {
+    return "invalid waiting queue";
+  }
+  snapshot.waiting_queue.resize(count);
+  for (std::string &client_name : snapshot.waiting_queue) {
+    if (!readClientName(cursor, end, client_name)) {
+      return "truncated waiting queue";
+    }
+  }
+
+  if (!readCount(cursor, end, count)) {
+    return "truncated bills";
+  }
+  snapshot.bills.resize(count);
+  for (ClientBill &bill : snapshot.bills) {
+    std::uint64_t sessions, billed_hours, minutes, revenue;
+    if (!readClientName(cursor, end, bill.client_name) ||
+        !readBounded(cursor, end, UINT32_MAX, sessions) ||
+        !readBounded(cursor, end, UINT32_MAX, billed_hours) ||
+        !readBounded(cursor, end, INT64_MAX, minutes) ||
+        !readBounded(cursor, end, INT64_MAX, revenue)) {
+      return "truncated bills";
+    }
+    bill.sessions = static_cast<std::uint32_t>(sessions);
+    bill.billed_hours = static_cast<std::uint32_t>(billed_hours);
+    bill.minutes = static_cast<std::int64_t>(minutes);
+    bill.revenue = static_cast<std::int64_t>(revenue);
+  }
+
+  if (cursor == end || *cursor > 1) {
+    return "truncated event log flag";
+  }
+  snapshot.has_event_log = *cursor++ == 1;
+  if (snapshot.has_event_log) {
+    std::string image;
+    event_archive::Reader reader;
+    std::optional<std::string> error;
+    if (!readBytes(cursor, end, image)) {
+      return "truncated event log";
+    }
+    error = reader.open(image);
+    if (!error.has_value()) {
+      error = reader.readAll(snapshot.event_log);
+    }
+    if (error.has_value()) {
+      return "invalid event log: " + error.value();
+    }
+  }
+
+  if (cursor != end) {
+    return "trailing bytes after snapshot";
+  }
+  return std::nullopt;
+}
+
+} // namespace club_snapshot
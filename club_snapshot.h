@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "computer_club.h"
+
+// Binary form of ClubStateSnapshot, for replay checkpoints and resumable
+// runs.
+//
+// Layout (version 1, all integers are LEB128 varints unless noted):
+//   "CCSS" magic, u8 version
+//   num_tables, open minutes, close minutes, hourly rate
+//   table count, then per table: id, minutes used, revenue,
+//     length + client name (empty if free), session start minutes
+//   client count, then per client: length + name, u8 location, table id
+//   queue length, then length + name per queued client
+//   bill count, then per client: length + name, sessions, billed hours,
+//     minutes, revenue
+//   u8 1 if an event log follows, then length + event log archive image
+//   (see event_archive.h)
+namespace club_snapshot {
+
+constexpr char kMagic[4] = {'C', 'C', 'S', 'S'};
+constexpr std::uint8_t kVersion = 1;
+
+std::string encode(const ClubStateSnapshot &snapshot);
+// returns error description on malformed or inconsistent data
+std::optional<std::string> decode(const std::string &data,
+                                  ClubStateSnapshot &snapshot);
+
+} // namespace club_snapshot
@@ -0,0 +1,99 @@
+#include "club_timeline.h"
+
+#include <cstring>
+#include <ostream>
+
+#include "binary_format.h"
+#include "computer_club.h"
+
+OccupancyCurve OccupancyTimeline::curve(int open_minutes,
+                                        int close_minutes) const {
+  OccupancyCurve result;
+  result.open_minutes = open_minutes;
+  if (close_minutes <= open_minutes) {
+    return result;
+  }
+  std::size_t length = static_cast<std::size_t>(close_minutes - open_minutes);
+  result.occupied_tables.reserve(length);
+  result.queue_length.reserve(length);
+  std::int64_t occupied = 0;
+  std::int64_t queued = 0;
+  for (int minute = 0; minute < close_minutes; ++minute) {
+    occupied += occupied_diff[minute];
+    queued += queue_diff[minute];
+    if (minute >= open_minutes) {
+      result.occupied_tables.push_back(static_cast<std::uint32_t>(occupied));
+      result.queue_length.push_back(static_cast<std::uint32_t>(queued));
+    }
+  }
+  return result;
+}
+
+namespace occupancy_format {
+
+using binary_format::readVarint;
+using binary_format::writeVarint;
+
+std::string encode(const OccupancyCurve &curve) {
+  std::string out(kMagic, sizeof(kMagic));
+  out.push_back(static_cast<char>(kVersion));
+  writeVarint(out, static_cast<std::uint64_t>(curve.open_minutes));
+  writeVarint(out, curve.occupied_tables.size());
+  for (std::size_t i = 0; i < curve.occupied_tables.size(); ++i) {
+    writeVarint(out, curve.occupied_tables[i]);
+    writeVarint(out, curve.queue_length[i]);
+  }
+  return out;
+}
+
+std::optional<std::string> decode(const std::string &data,
+                                  OccupancyCurve &curve) {
+  const auto *cursor = reinterpret_cast<const std::uint8_t *>(data.data());
+  const std::uint8_t *end = cursor + data.size();
+  if (data.size() < sizeof(kMagic) + 1 ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return "not an occupancy timeline";
+  }
+  cursor += sizeof(kMagic);
+  if (*cursor++ != kVersion) {
+    return "unsupported occupancy timeline version";
+  }
+  std::uint64_t open_minutes, minute_count;
+  if (!readVarint(cursor, end, open_minutes) ||
+      !readVarint(cursor, end, minute_count)) {
+    return "truncated occupancy timeline";
+  }
+  if (open_minutes + minute_count > OccupancyTimeline::kSlots) {
+    return "occupancy timeline longer than a day";
+  }
+
+  OccupancyCurve result;
+  result.open_minutes = static_cast<int>(open_minutes);
+  result.occupied_tables.resize(minute_count);
+  result.queue_length.resize(minute_count);
+  for (std::size_t i = 0; i < minute_count; ++i) {
+    std::uint64_t occupied, queued;
+    if (!readVarint(cursor, end, occupied) ||
+        !readVarint(cursor, end, queued)) {
+      return "truncated occupancy timeline";
+    }
+    result.occupied_tables[i] = static_cast<std::uint32_t>(occupied);
+    result.queue_length[i] = static_cast<std::uint32_t>(queued);
+  }
+  if (cursor != end) {
+    return "trailing bytes after occupancy timeline";
+  }
+  curve = std::move(result);
+  return std::nullopt;
+}
+
+void writeCsv(const OccupancyCurve &curve, std::ostream &output) {
+  output << "minute,occupied_tables,queue_length\n";
+  for (std::size_t i = 0; i < curve.occupied_tables.size(); ++i) {
+    output << Time(curve.open_minutes + static_cast<int>(i)).toString() << ','
+           << curve.occupied_tables[i] << ',' << curve.queue_length[i]
+           << '\n';
+  }
+}
+
+} // namespace occupancy_format
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+// --- occupied tables and queue length for every minute of the day ---
+struct OccupancyCurve {
+  // minute of the day of the first entry
+  int open_minutes = 0;
+  // state after all events of a minute, one entry per minute from the
+  // opening time up to, not including, the closing time
+  std::vector<std::uint32_t> occupied_tables;
+  std::vector<std::uint32_t> queue_length;
+
+  bool operator==(const OccupancyCurve &other) const = default;
+};
+
+// Difference arrays over a fixed 1440-slot day: an event adds the change
+// of each count to the slot of its minute, O(1) and fixed memory; the
+// curve is one prefix-sum pass.
+class OccupancyTimeline {
+public:
+  static constexpr int kSlots = 24 * 60;
+
+private:
+  std::array<std::int32_t, kSlots> occupied_diff{};
+  std::array<std::int32_t, kSlots> queue_diff{};
+  int last_occupied = 0;
+  int last_queue_length = 0;
+
+public:
+  // counts after the events of minute, minutes never decrease
+  void update(int minute, int occupied_tables, std::size_t queue_length) {
+    int length = static_cast<int>(queue_length);
+    occupied_diff[minute] += occupied_tables - last_occupied;
+    queue_diff[minute] += length - last_queue_length;
+    last_occupied = occupied_tables;
+    last_queue_length = length;
+  }
+  void clear() { *this = OccupancyTimeline(); }
+
+  // minutes [open_minutes, close_minutes)
+  OccupancyCurve curve(int open_minutes, int close_minutes) const;
+};
+
+// Binary form of OccupancyCurve.
+//
+// Layout (version 1, all integers are LEB128 varints unless noted):
+//   "CCOT" magic, u8 version
+//   open minutes, minute count
+//   per minute: occupied tables, queue length
+namespace occupancy_format {
+
+constexpr char kMagic[4] = {'C', 'C', 'O', 'T'};
+constexpr std::uint8_t kVersion = 1;
+
+std::string encode(const OccupancyCurve &curve);
+// returns error description on malformed data
+std::optional<std::string> decode(const std::string &data,
+                                  OccupancyCurve &curve);
+
+// header "minute,occupied_tables,queue_length", then <HH:MM>,<n>,<n>
+void writeCsv(const OccupancyCurve &curve, std::ostream &output);
+
+} // namespace occupancy_format
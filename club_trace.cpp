@@ -0,0 +1,183 @@
+#include "club_trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+
+namespace {
+
+std::atomic<std::uint64_t> next_tracer_id{1};
+
+std::uint64_t steadyNs() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+// last ring looked up by this thread; tracer ids are never reused, so a
+// stale entry of a destroyed tracer can not match a live one
+struct CachedRing {
+  std::uint64_t tracer_id = 0;
+  TraceRing *ring = nullptr;
+};
+thread_local CachedRing cached_ring;
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+  std::size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// microseconds with ns precision, the unit of "ts" and "dur"
+void writeMicroseconds(std::ostream &output, std::uint64_t ns) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%llu.%03llu",
+                static_cast<unsigned long long>(ns / 1000),
+                static_cast<unsigned long long>(ns % 1000));
+  output << buffer;
+}
+
+void writeJsonString(std::ostream &output, const char *text) {
+  output << '"';
+  for (const char *c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      output << '\\';
+    }
+    output << *c;
+  }
+  output << '"';
+}
+
+} // namespace
+
+// --- class TraceRing ---
+TraceRing::TraceRing(std::size_t capacity, std::uint32_t thread_index)
+    : slots(std::make_unique<TraceSpan[]>(roundUpToPowerOfTwo(capacity))),
+      mask(roundUpToPowerOfTwo(capacity) - 1), thread_index(thread_index) {}
+
+std::uint32_t TraceRing::threadIndex() const { return thread_index; }
+
+std::vector<TraceSpan> TraceRing::spans() const {
+  std::uint64_t total = pushed.load(std::memory_order_acquire);
+  std::uint64_t capacity = mask + 1;
+  std::uint64_t first = total > capacity ? total - capacity : 0;
+  std::vector<TraceSpan> result;
+  result.reserve(total - first);
+  for (std::uint64_t position = first; position < total; ++position) {
+    result.push_back(slots[position & mask]);
+  }
+  return result;
+}
+
+std::uint64_t TraceRing::overwritten() const {
+  std::uint64_t total = pushed.load(std::memory_order_acquire);
+  return total > mask + 1 ? total - (mask + 1) : 0;
+}
+
+// --- class Tracer ---
+Tracer::Tracer(std::size_t spans_per_thread,
+               std::uint32_t event_sample_interval)
+    : id(next_tracer_id.fetch_add(1)), origin_ns(steadyNs()),
+      spans_per_thread(spans_per_thread),
+      event_sample_interval(event_sample_interval) {}
+
+std::uint64_t Tracer::now() const { return steadyNs() - origin_ns; }
+
+TraceRing &Tracer::threadRing() {
+  if (cached_ring.tracer_id != id) {
+    cached_ring.ring = &registerThread();
+    cached_ring.tracer_id = id;
+  }
+  return *cached_ring.ring;
+}
+
+TraceRing &Tracer::registerThread() {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  std::thread::id self = std::this_thread::get_id();
+  for (std::size_t i = 0; i < ring_owners.size(); ++i) {
+    if (ring_owners[i] == self) {
+      return *rings[i];
+    }
+  }
+  rings.push_back(std::make_unique<TraceRing>(
+      spans_per_thread, static_cast<std::uint32_t>(rings.size())));
+  ring_owners.push_back(self);
+  return *rings.back();
+}
+
+std::uint32_t Tracer::eventSampleInterval() const {
+  return event_sample_interval;
+}
+
+std::size_t Tracer::spanCount() const {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  std::size_t count = 0;
+  for (const std::unique_ptr<TraceRing> &ring : rings) {
+    count += ring->spans().size();
+  }
+  return count;
+}
+
+std::optional<std::string>
+Tracer::writeChromeTrace(std::ostream &output) const {
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  std::uint64_t overwritten = 0;
+  output << "{\"traceEvents\":[";
+  bool first = true;
+  for (const std::unique_ptr<TraceRing> &ring : rings) {
+    output << (first ? "\n" : ",\n");
+    first = false;
+    output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << ring->threadIndex() << ",\"args\":{\"name\":\"thread "
+           << ring->threadIndex() << "\"}}";
+    for (const TraceSpan &span : ring->spans()) {
+      output << ",\n{\"name\":";
+      writeJsonString(output, span.name);
+      output << ",\"cat\":\"club\",\"ph\":\"X\",\"ts\":";
+      writeMicroseconds(output, span.start_ns);
+      output << ",\"dur\":";
+      writeMicroseconds(output, span.end_ns - span.start_ns);
+      output << ",\"pid\":1,\"tid\":" << ring->threadIndex() << '}';
+    }
+    overwritten += ring->overwritten();
+  }
+  output << "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{"
+            "\"overwritten_spans\":"
+         << overwritten << "}}\n";
+  if (!output) {
+    return "write error";
+  }
+  return std::nullopt;
+}
+
+// --- class TraceScope ---
+TraceScope::TraceScope(Tracer *tracer, const char *name) : tracer(tracer) {
+  if (tracer != nullptr) {
+    span.name = name;
+    span.start_ns = tracer->now();
+  }
+}
+
+TraceScope::~TraceScope() {
+  if (tracer != nullptr) {
+    span.end_ns = tracer->now();
+    tracer->threadRing().push(span);
+  }
+}
+
+const char *eventHandlerSpanName(int event_id) {
+  switch (event_id) {
+  case 1:
+    return "handleClientArrived";
+  case 2:
+    return "handleClientSat";
+  case 3:
+    return "handleClientWaited";
+  case 4:
+    return "handleClientLeft";
+  }
+  return "processEvent";
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Span recording for profiling runs, written out in the Chrome trace-event
+// format (chrome://tracing, Perfetto). Every thread records into its own
+// ring, so recording a span is two clock reads and a few stores with no
+// locks or shared cache lines; the rings are collected once at exit.
+
+// one finished span, times in ns since the tracer was created
+struct TraceSpan {
+  // must point to a string that outlives the tracer, normally a literal
+  const char *name = nullptr;
+  std::uint64_t start_ns = 0;
+  std::uint64_t end_ns = 0;
+};
+
+// --- spans of one thread ---
+// Single producer: only the owning thread pushes. When full, the oldest
+// spans are overwritten, so a long run keeps its most recent spans.
+class TraceRing {
+private:
+  std::unique_ptr<TraceSpan[]> slots;
+  std::size_t mask;
+  std::atomic<std::uint64_t> pushed{0};
+  std::uint32_t thread_index;
+
+public:
+  // capacity is rounded up to a power of two
+  TraceRing(std::size_t capacity, std::uint32_t thread_index);
+
+  void push(const TraceSpan &span) {
+    std::uint64_t position = pushed.load(std::memory_order_relaxed);
+    slots[position & mask] = span;
+    pushed.store(position + 1, std::memory_order_release);
+  }
+
+  std::uint32_t threadIndex() const;
+  // spans still held, oldest first
+  std::vector<TraceSpan> spans() const;
+  // spans lost to overwriting
+  std::uint64_t overwritten() const;
+};
+
+class Tracer {
+private:
+  std::uint64_t id;
+  std::uint64_t origin_ns;
+  std::size_t spans_per_thread;
+  std::uint32_t event_sample_interval;
+  mutable std::mutex rings_mutex;
+  std::vector<std::unique_ptr<TraceRing>> rings;
+  std::vector<std::thread::id> ring_owners;
+
+  TraceRing &registerThread();
+
+public:
+  // event_sample_interval: every n-th event also gets a span of its own
+  // handler, on top of the per-batch spans; 0 records no per-event spans
+  explicit Tracer(std::size_t spans_per_thread = 1 << 16,
+                  std::uint32_t event_sample_interval = 1024);
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  // ns since the tracer was created
+  std::uint64_t now() const;
+  // ring of the calling thread, registered on first use
+  TraceRing &threadRing();
+  std::uint32_t eventSampleInterval() const;
+
+  std::size_t spanCount() const;
+  // Call once the traced threads are done recording.
+  // Returns error description on write failure.
+  std::optional<std::string> writeChromeTrace(std::ostream &output) const;
+};
+
+// --- span covering the lifetime of the scope, no-op without a tracer ---
+class TraceScope {
+private:
+  Tracer *tracer;
+  TraceSpan span;
+
+public:
+  TraceScope(Tracer *tracer, const char *name);
+  ~TraceScope();
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+};
+
+// span name of the handler for an incoming event ID 1-4
+const char *eventHandlerSpanName(int event_id);
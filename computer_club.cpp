@@ -1,32 +1,16 @@
 #include "computer_club.h"
+#include <cctype>
+#include <charconv>
 #include <iostream>
 #include <limits>
 
 namespace utils {
 int parsePositiveInteger(const std::string &s) {
-  if (s.empty()) {
-    return -1;
-  }
-  for (char c : s) {
-    if (!std::isdigit(c)) {
-      return -1;
-    }
-  }
-  try {
-    if (s.length() > 1 && s[0] == '0') {
-      return -1;
-    }
-    unsigned long long val = std::stoull(s);
-    if (val == 0 || val > static_cast<unsigned long long>(
-                              std::numeric_limits<int>::max())) {
-      return -1;
-    }
-    return static_cast<int>(val);
-  } catch (const std::out_of_range &) {
-    return -1;
-  } catch (const std::invalid_argument &) {
+  int value = 0;
+  if (!isValidIntegerString(s, value, 1, std::numeric_limits<int>::max())) {
     return -1;
   }
+  return value;
 }
 
 bool isValidIntegerString(const std::string &s, int &out_val, int min_val,
@@ -37,21 +21,22 @@ bool isValidIntegerString(const std::string &s, int &out_val, int min_val,
     if (!std::isdigit(c))
       return false;
   }
-  try {
-    if (s.length() > 1 && s[0] == '0')
-      return false;
-    if (s == "0" && min_val > 0)
-      return false;
+  if (s.length() > 1 && s[0] == '0')
+    return false;
+  if (s == "0" && min_val > 0)
+    return false;
 
-    long long val = std::stoll(s);
-    if (val < min_val || val > max_val) {
-      return false;
-    }
-    out_val = static_cast<int>(val);
-    return true;
-  } catch (const std::exception &) {
+  // digits only, so from_chars can fail on overflow alone
+  long long val = 0;
+  auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), val);
+  if (ec != std::errc() || end != s.data() + s.size()) {
+    return false;
+  }
+  if (val < min_val || val > max_val) {
     return false;
   }
+  out_val = static_cast<int>(val);
+  return true;
 }
 
 bool isValidClientName(const std::string &name) {
@@ -85,6 +70,13 @@ Time::Time(int total_minutes) {
 int Time::toMinutes() const { return hours * 60 + minutes; }
 
 std::string Time::toString() const {
+  if (hours >= 0 && hours < 100 && minutes >= 0 && minutes < 100) {
+    char text[5] = {static_cast<char>('0' + hours / 10),
+                    static_cast<char>('0' + hours % 10), ':',
+                    static_cast<char>('0' + minutes / 10),
+                    static_cast<char>('0' + minutes % 10)};
+    return std::string(text, sizeof(text));
+  }
   std::ostringstream oss;
   oss << std::setw(2) << std::setfill('0') << hours << ":" << std::setw(2)
       << std::setfill('0') << minutes;
@@ -118,22 +110,60 @@ Time Time::addMinutes(int mins_to_add) const {
   return Time(this->toMinutes() + mins_to_add);
 }
 
-Time Time::parse(const std::string &s) {
+namespace {
+// accepts the same prefixes as std::stoi: leading spaces, sign, digits
+bool parseTimePart(const char *begin, const char *end, int &out) noexcept {
+  while (begin != end && std::isspace(static_cast<unsigned char>(*begin))) {
+    ++begin;
+  }
+  bool negative = false;
+  if (begin != end && (*begin == '+' || *begin == '-')) {
+    negative = *begin == '-';
+    ++begin;
+  }
+  if (begin == end || !std::isdigit(static_cast<unsigned char>(*begin))) {
+    return false;
+  }
+  int value = 0;
+  while (begin != end && std::isdigit(static_cast<unsigned char>(*begin))) {
+    value = value * 10 + (*begin - '0');
+    ++begin;
+  }
+  out = negative ? -value : value;
+  return true;
+}
+} // namespace
+
+TimeParseStatus Time::tryParse(const std::string &s, Time &out) noexcept {
   if (s.length() != 5 || s[2] != ':') {
-    throw std::runtime_error("Invalid time format: " + s);
+    return TimeParseStatus::INVALID_FORMAT;
   }
-  try {
-    int h = std::stoi(s.substr(0, 2));
-    int m = std::stoi(s.substr(3, 2));
-    if (h < 0 || h > 23 || m < 0 || m > 59) {
-      throw std::runtime_error("Invalid time value: " + s);
-    }
-    return Time(h, m);
-  } catch (const std::invalid_argument &) {
+  int h = 0;
+  int m = 0;
+  if (!parseTimePart(s.data(), s.data() + 2, h) ||
+      !parseTimePart(s.data() + 3, s.data() + 5, m)) {
+    return TimeParseStatus::NOT_A_NUMBER;
+  }
+  if (h < 0 || h > 23 || m < 0 || m > 59) {
+    return TimeParseStatus::INVALID_VALUE;
+  }
+  out = Time(h, m);
+  return TimeParseStatus::OK;
+}
+
+Time Time::parse(const std::string &s) {
+  Time result;
+  switch (tryParse(s, result)) {
+  case TimeParseStatus::OK:
+    return result;
+  case TimeParseStatus::INVALID_FORMAT:
+    throw std::runtime_error("Invalid time format: " + s);
+  case TimeParseStatus::NOT_A_NUMBER:
     throw std::runtime_error("Time string part is not a number: " + s);
-  } catch (const std::out_of_range &) {
-    throw std::runtime_error("Time string number out of range: " + s);
+  case TimeParseStatus::INVALID_VALUE:
+    break;
   }
+  throw std::runtime_error("Invalid time value: " + s);
 }
 
 // --- struct Event ---
@@ -190,50 +220,36 @@ void TableInfo::free(const Time &current_time, int hour_price) {
   }
 
   total_minutes_used += duration_minutes;
-
-  int billed_hours = (duration_minutes + 59) / 60;
-  revenue_generated += billed_hours * hour_price;
+  revenue_generated += billedHours(duration_minutes) * hour_price;
 
   is_occupied = false;
   current_client_name = "";
 }
 
-// --- struct ClientInfo ---
-ClientInfo::ClientInfo(ClientLocation loc, int tbl_id)
-    : location(loc), table_id(tbl_id) {}
-
-// --- class ComputerClub ---
-ComputerClub::ComputerClub() {}
-
-void ComputerClub::addEventToLog(const Event &event) {
-  event_log_output.push_back(event);
-}
-
-void ComputerClub::addErrorEventToLog(const Time &event_time,
-                                      const std::string &error_message) {
-  Event err_event = Event::newErrorEvent(event_time, error_message);
-  event_log_output.push_back(err_event);
-}
-
-bool ComputerClub::isClientInClub(const std::string &client_name) const {
-  return clients_in_club_state.count(client_name);
-}
-
-bool ComputerClub::isWorkingTime(const Time &current_time) const {
-  return current_time >= open_time_config && current_time < close_time_config;
+// --- struct TableStatsSummary ---
+int TableStatsSummary::numTables() const {
+  return static_cast<int>(minutes_used.size());
 }
 
-int ComputerClub::findFreeTable() const {
-  for (const auto &table : tables_state) {
-    if (!table.is_occupied) {
-      return table.id;
-    }
+void TableStatsSummary::merge(const TableStatsSummary &other) {
+  if (other.minutes_used.size() > minutes_used.size()) {
+    minutes_used.resize(other.minutes_used.size(), 0);
+    revenue.resize(other.revenue.size(), 0);
   }
-  return 0;
+  for (std::size_t i = 0; i < other.minutes_used.size(); ++i) {
+    minutes_used[i] += other.minutes_used[i];
+    revenue[i] += other.revenue[i];
+  }
+  days += other.days;
+  distributions.merge(other.distributions);
 }
 
-std::optional<std::string>
-ComputerClub::loadConfiguration(std::istream &configFileStream) {
+// --- struct ClientInfo ---
+ClientInfo::ClientInfo(ClientLocation loc, int tbl_id)
+    : location(loc), table_id(tbl_id) {}
+
+std::optional<std::string> loadClubConfiguration(std::istream &configFileStream,
+                                                 ClubConfig &config) {
   std::string line;
   // 1. Count tables
   if (!std::getline(configFileStream, line))
@@ -250,8 +266,8 @@ ComputerClub::loadConfiguration(std::istream &configFileStream) {
     return line;
   } // extra data
 
-  this->num_tables_config = utils::parsePositiveInteger(num_tables_str);
-  if (this->num_tables_config == -1)
+  config.num_tables = utils::parsePositiveInteger(num_tables_str);
+  if (config.num_tables == -1)
     return line;
 
   // 2. working hours
@@ -268,14 +284,12 @@ ComputerClub::loadConfiguration(std::istream &configFileStream) {
   if (iss_times >> temp_extra_times)
     return line; // extra data
 
-  try {
-    this->open_time_config = Time::parse(open_time_str);
-    this->close_time_config = Time::parse(close_time_str);
-  } catch (const std::runtime_error &) {
+  if (Time::tryParse(open_time_str, config.open_time) != TimeParseStatus::OK ||
+      Time::tryParse(close_time_str, config.close_time) !=
+          TimeParseStatus::OK)
     return line;
-  }
 
-  if (!(this->open_time_config < this->close_time_config))
+  if (!(config.open_time < config.close_time))
     return line;
 
   // 3. cost of hour
@@ -293,33 +307,25 @@ ComputerClub::loadConfiguration(std::istream &configFileStream) {
     return line;
   } // extra data
 
-  this->hourly_rate_config = utils::parsePositiveInteger(hourly_rate_str);
-  if (this->hourly_rate_config == -1)
+  config.hourly_rate = utils::parsePositiveInteger(hourly_rate_str);
+  if (config.hourly_rate == -1)
     return line;
 
-  this->tables_state.clear();
-  this->tables_state.reserve(this->num_tables_config);
-  for (int i = 0; i < this->num_tables_config; ++i) {
-    this->tables_state.emplace_back(i + 1);
-  }
   return std::nullopt;
 }
 
-std::optional<ComputerClub::ParsedEventInput>
-ComputerClub::parseEventDetails(const std::string &eventLine) {
+std::optional<EventInput> parseEventInput(const std::string &eventLine,
+                                          int num_tables) {
   std::istringstream iss(eventLine);
   std::string time_str, id_str;
-  ParsedEventInput data;
+  EventInput data;
 
   iss >> time_str >> id_str;
   if (iss.fail())
     return std::nullopt;
 
-  try {
-    data.time = Time::parse(time_str);
-  } catch (const std::runtime_error &) {
+  if (Time::tryParse(time_str, data.time) != TimeParseStatus::OK)
     return std::nullopt;
-  }
 
   if (!utils::isValidIntegerString(id_str, data.id, 1, 4)) {
     return std::nullopt;
@@ -347,8 +353,7 @@ ComputerClub::parseEventDetails(const std::string &eventLine) {
     if (iss.fail() || !utils::isValidClientName(client_name_str_temp))
       return std::nullopt;
     if (!utils::isValidIntegerString(table_id_str_param_temp,
-                                     table_id_param_val, 1,
-                                     this->num_tables_config))
+                                     table_id_param_val, 1, num_tables))
       return std::nullopt;
 
     // extra data
@@ -364,8 +369,292 @@ ComputerClub::parseEventDetails(const std::string &eventLine) {
   return data;
 }
 
-void ComputerClub::handleClientArrived(const Time &event_time,
-                                       const std::string &client_name) {
+// --- class ClientRegistry ---
+std::uint32_t ClientRegistry::intern(const std::string &client_name) {
+  auto it = ids.find(client_name);
+  if (it != ids.end()) {
+    return it->second;
+  }
+  MemoryScope memory_scope(MemorySubsystem::STRINGS);
+  std::uint32_t client_id = static_cast<std::uint32_t>(names.size());
+  names.push_back(client_name);
+  ids.emplace(names.back(), client_id);
+  return client_id;
+}
+
+std::uint32_t ClientRegistry::find(const std::string &client_name) const {
+  auto it = ids.find(client_name);
+  return it == ids.end() ? kNoClient : it->second;
+}
+
+const std::string &ClientRegistry::name(std::uint32_t client_id) const {
+  return names[client_id];
+}
+
+std::size_t ClientRegistry::size() const { return names.size(); }
+
+void ClientRegistry::clear() {
+  MemoryScope memory_scope(MemorySubsystem::STRINGS);
+  ids.clear();
+  names.clear();
+}
+
+// --- class ClientLedger ---
+void ClientLedger::charge(const SessionCharge &session) {
+  if (session.client_id == ClientRegistry::kNoClient) {
+    return;
+  }
+  std::size_t id = session.client_id;
+  if (id >= sessions.size()) {
+    MemoryScope memory_scope(MemorySubsystem::CLIENT_STATE);
+    // ids are dense and grow one by one, so this rarely reallocates
+    std::size_t size = std::max(id + 1, sessions.size() * 2);
+    sessions.resize(size, 0);
+    billed_hours.resize(size, 0);
+    minutes.resize(size, 0);
+    revenue.resize(size, 0);
+  }
+  ++sessions[id];
+  billed_hours[id] += session.billed_hours;
+  minutes[id] += session.minutes;
+  revenue[id] += session.revenue;
+}
+
+ClientBill ClientLedger::bill(std::uint32_t client_id,
+                              const ClientRegistry &names) const {
+  ClientBill result;
+  if (client_id == ClientRegistry::kNoClient) {
+    return result;
+  }
+  result.client_name = names.name(client_id);
+  if (client_id < sessions.size()) {
+    result.sessions = sessions[client_id];
+    result.billed_hours = billed_hours[client_id];
+    result.minutes = minutes[client_id];
+    result.revenue = revenue[client_id];
+  }
+  return result;
+}
+
+std::vector<ClientBill>
+ClientLedger::topSpenders(std::size_t count,
+                          const ClientRegistry &names) const {
+  std::vector<std::uint32_t> ids;
+  for (std::uint32_t id = 0; id < sessions.size(); ++id) {
+    if (sessions[id] != 0) {
+      ids.push_back(id);
+    }
+  }
+  count = std::min(count, ids.size());
+  std::partial_sort(ids.begin(), ids.begin() + count, ids.end(),
+                    [this, &names](std::uint32_t a, std::uint32_t b) {
+                      if (revenue[a] != revenue[b]) {
+                        return revenue[a] > revenue[b];
+                      }
+                      return names.name(a) < names.name(b);
+                    });
+
+  std::vector<ClientBill> top;
+  top.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    top.push_back(bill(ids[i], names));
+  }
+  return top;
+}
+
+void ClientLedger::restore(std::uint32_t client_id,
+                           const ClientBill &totals) {
+  if (client_id >= sessions.size()) {
+    MemoryScope memory_scope(MemorySubsystem::CLIENT_STATE);
+    std::size_t size = client_id + 1;
+    sessions.resize(size, 0);
+    billed_hours.resize(size, 0);
+    minutes.resize(size, 0);
+    revenue.resize(size, 0);
+  }
+  sessions[client_id] = totals.sessions;
+  billed_hours[client_id] = totals.billed_hours;
+  minutes[client_id] = totals.minutes;
+  revenue[client_id] = totals.revenue;
+}
+
+void ClientLedger::clear() {
+  sessions.clear();
+  billed_hours.clear();
+  minutes.clear();
+  revenue.clear();
+}
+
+// --- class TableSet<kSparseTables> ---
+void TableSet<kSparseTables>::reset(int num_tables) {
+  MemoryScope memory_scope(MemorySubsystem::TABLE_STATE);
+  slot_of_table.clear();
+  table_ids.clear();
+  occupied.clear();
+  session_start_minutes.clear();
+  client_ids.clear();
+  minutes_used.clear();
+  revenue.clear();
+  free_touched_tables.clear();
+  first_untouched_table = 1;
+  count = num_tables;
+  occupied_count = 0;
+}
+
+std::uint32_t TableSet<kSparseTables>::touch(int table_id) {
+  auto [it, inserted] = slot_of_table.try_emplace(
+      table_id, static_cast<std::uint32_t>(table_ids.size()));
+  if (inserted) {
+    table_ids.push_back(table_id);
+    occupied.push_back(0);
+    session_start_minutes.push_back(0);
+    client_ids.push_back(ClientRegistry::kNoClient);
+    minutes_used.push_back(0);
+    revenue.push_back(0);
+    while (first_untouched_table <= count &&
+           slot_of_table.count(first_untouched_table)) {
+      ++first_untouched_table;
+    }
+  }
+  return it->second;
+}
+
+void TableSet<kSparseTables>::occupy(int table_id, std::uint32_t client_id,
+                                     const Time &current_time) {
+  MemoryScope memory_scope(MemorySubsystem::TABLE_STATE);
+  std::uint32_t slot = touch(table_id);
+  if (!occupied[slot]) {
+    ++occupied_count;
+    free_touched_tables.erase(table_id);
+  }
+  occupied[slot] = 1;
+  session_start_minutes[slot] =
+      static_cast<std::uint16_t>(current_time.toMinutes());
+  client_ids[slot] = client_id;
+}
+
+SessionCharge TableSet<kSparseTables>::free(int table_id,
+                                            const Time &current_time,
+                                            int hour_price) {
+  SessionCharge session;
+  std::uint32_t slot = findSlot(table_id);
+  if (slot == ClientRegistry::kNoClient || !occupied[slot])
+    return session;
+  int duration_minutes = current_time.toMinutes() - session_start_minutes[slot];
+  if (duration_minutes < 0) {
+    duration_minutes = 0;
+  }
+  session.client_id = client_ids[slot];
+  session.minutes = duration_minutes;
+  session.billed_hours = billedHours(duration_minutes);
+  session.revenue = session.billed_hours * hour_price;
+  minutes_used[slot] += session.minutes;
+  revenue[slot] += session.revenue;
+
+  occupied[slot] = 0;
+  client_ids[slot] = ClientRegistry::kNoClient;
+  --occupied_count;
+  MemoryScope memory_scope(MemorySubsystem::TABLE_STATE);
+  free_touched_tables.insert(table_id);
+  return session;
+}
+
+void TableSet<kSparseTables>::restoreTotals(int table_id, int minutes,
+                                            int table_revenue) {
+  MemoryScope memory_scope(MemorySubsystem::TABLE_STATE);
+  std::uint32_t slot = touch(table_id);
+  minutes_used[slot] = minutes;
+  revenue[slot] = table_revenue;
+  if (!occupied[slot]) {
+    free_touched_tables.insert(table_id);
+  }
+}
+
+int TableSet<kSparseTables>::findFree() const {
+  if (occupied_count == count) {
+    return 0;
+  }
+  int best = first_untouched_table <= count ? first_untouched_table : 0;
+  if (!free_touched_tables.empty() &&
+      (best == 0 || *free_touched_tables.begin() < best)) {
+    best = *free_touched_tables.begin();
+  }
+  return best;
+}
+
+// --- class ComputerClub ---
+template <std::size_t MaxTables>
+BasicComputerClub<MaxTables>::BasicComputerClub() {}
+
+template <std::size_t MaxTables>
+std::optional<std::string> BasicComputerClub<MaxTables>::loadConfiguration(
+    std::istream &configFileStream) {
+  ClubConfig config;
+  std::optional<std::string> error_line =
+      loadClubConfiguration(configFileStream, config);
+  if (!error_line.has_value()) {
+    this->applyConfiguration(config);
+  }
+  return error_line;
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::addEventToLog(const Event &event) {
+  MemoryScope memory_scope(MemorySubsystem::EVENT_LOG);
+  event_log_output.push_back(event);
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::addErrorEventToLog(
+    const Time &event_time, const std::string &error_message) {
+  Event err_event = Event::newErrorEvent(event_time, error_message);
+  MemoryScope memory_scope(MemorySubsystem::EVENT_LOG);
+  event_log_output.push_back(err_event);
+}
+
+template <std::size_t MaxTables>
+bool BasicComputerClub<MaxTables>::isClientInClub(
+    const std::string &client_name) const {
+  return clients_in_club_state.count(client_name);
+}
+
+template <std::size_t MaxTables>
+bool BasicComputerClub<MaxTables>::isWorkingTime(
+    const Time &current_time) const {
+  return current_time >= open_time_config && current_time < close_time_config;
+}
+
+template <std::size_t MaxTables>
+int BasicComputerClub<MaxTables>::findFreeTable() const {
+  return tables_state.findFree();
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::applyConfiguration(
+    const ClubConfig &config) {
+  this->num_tables_config = config.num_tables;
+  this->open_time_config = config.open_time;
+  this->close_time_config = config.close_time;
+  this->hourly_rate_config = config.hourly_rate;
+
+  this->client_registry.clear();
+  this->client_ledger.clear();
+  this->revenue_total = 0;
+  this->distributions.clear();
+  this->occupancy_timeline.clear();
+  this->tables_state.reset(this->num_tables_config);
+  this->waiting_queue_state.clear();
+}
+
+template <std::size_t MaxTables>
+std::optional<EventInput>
+BasicComputerClub<MaxTables>::parseEventDetails(const std::string &eventLine) {
+  return parseEventInput(eventLine, this->num_tables_config);
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::handleClientArrived(
+    const Time &event_time, const std::string &client_name) {
   if (this->isClientInClub(client_name)) {
     this->addErrorEventToLog(event_time, "YouShallNotPass");
   } else if (!this->isWorkingTime(event_time)) {
@@ -376,30 +665,31 @@ void ComputerClub::handleClientArrived(const Time &event_time,
   }
 }
 
-void ComputerClub::handleClientSat(const Time &event_time,
-                                   const std::string &client_name,
-                                   int table_id) {
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::handleClientSat(
+    const Time &event_time, const std::string &client_name, int table_id) {
   if (!this->isClientInClub(client_name)) {
     this->addErrorEventToLog(event_time, "ClientUnknown");
-  } else if (tables_state[table_id - 1].is_occupied) {
+  } else if (tables_state.isOccupied(table_id)) {
     this->addErrorEventToLog(event_time, "PlaceIsBusy");
   } else {
     ClientInfo &clientInfo = clients_in_club_state[client_name];
 
     if (clientInfo.table_id != 0 && clientInfo.table_id != table_id) {
-      tables_state[clientInfo.table_id - 1].free(event_time,
-                                                 hourly_rate_config);
+      this->freeTable(clientInfo.table_id, event_time);
     } else if (clientInfo.table_id == table_id) { // PlaceIsBusy
     }
 
-    tables_state[table_id - 1].occupy(client_name, event_time);
+    tables_state.occupy(table_id, client_registry.intern(client_name),
+                        event_time);
     clientInfo.location = ClientLocation::AT_TABLE;
     clientInfo.table_id = table_id;
   }
 }
 
-void ComputerClub::handleClientWaited(const Time &event_time,
-                                      const std::string &client_name) {
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::handleClientWaited(
+    const Time &event_time, const std::string &client_name) {
   if (!this->isClientInClub(client_name)) {
     this->addErrorEventToLog(event_time, "ClientUnknown");
     return;
@@ -429,9 +719,10 @@ void ComputerClub::handleClientWaited(const Time &event_time,
 
     int current_table_id = clientInfo.table_id;
 
-    tables_state[current_table_id - 1].free(event_time, hourly_rate_config);
+    this->freeTable(current_table_id, event_time);
     clientInfo.table_id = 0;
     clientInfo.location = ClientLocation::IN_QUEUE;
+    clientInfo.queued_minutes = event_time.toMinutes();
 
     waiting_queue_state.push_back(client_name);
 
@@ -444,8 +735,10 @@ void ComputerClub::handleClientWaited(const Time &event_time,
 
           if (clients_in_club_state.count(first_in_queue)) {
             ClientInfo &occupant_info = clients_in_club_state[first_in_queue];
-            tables_state[current_table_id - 1].occupy(first_in_queue,
-                                                      event_time);
+            recordQueueWait(occupant_info, event_time);
+            tables_state.occupy(current_table_id,
+                                client_registry.intern(first_in_queue),
+                                event_time);
             occupant_info.location = ClientLocation::AT_TABLE;
             occupant_info.table_id = current_table_id;
             this->addEventToLog(Event::newClientTableEvent(
@@ -458,22 +751,17 @@ void ComputerClub::handleClientWaited(const Time &event_time,
 
   } else if (clientInfo.location == ClientLocation::IN_QUEUE) {
   } else {
-    bool already_in_queue = false;
-    for (const auto &name_in_q : waiting_queue_state) {
-      if (name_in_q == client_name) {
-        already_in_queue = true;
-        break;
-      }
-    }
-    if (!already_in_queue) {
+    if (!waiting_queue_state.contains(client_name)) {
       waiting_queue_state.push_back(client_name);
+      clientInfo.queued_minutes = event_time.toMinutes();
     }
     clientInfo.location = ClientLocation::IN_QUEUE;
   }
 }
 
-void ComputerClub::handleClientLeft(const Time &event_time,
-                                    const std::string &client_name) {
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::handleClientLeft(
+    const Time &event_time, const std::string &client_name) {
   if (!this->isClientInClub(client_name)) {
     this->addErrorEventToLog(event_time, "ClientUnknown");
   } else {
@@ -482,7 +770,7 @@ void ComputerClub::handleClientLeft(const Time &event_time,
 
     if (client_original_info.table_id != 0) {
       int freed_table_id = client_original_info.table_id;
-      tables_state[freed_table_id - 1].free(event_time, hourly_rate_config);
+      this->freeTable(freed_table_id, event_time);
 
       if (!waiting_queue_state.empty()) {
         std::string next_client_name_from_queue = waiting_queue_state.front();
@@ -491,9 +779,11 @@ void ComputerClub::handleClientLeft(const Time &event_time,
         if (clients_in_club_state.count(next_client_name_from_queue)) {
           ClientInfo &next_client_info_ref =
               clients_in_club_state[next_client_name_from_queue];
+          recordQueueWait(next_client_info_ref, event_time);
 
-          tables_state[freed_table_id - 1].occupy(next_client_name_from_queue,
-                                                  event_time);
+          tables_state.occupy(
+              freed_table_id,
+              client_registry.intern(next_client_name_from_queue), event_time);
           next_client_info_ref.location = ClientLocation::AT_TABLE;
           next_client_info_ref.table_id = freed_table_id;
           this->addEventToLog(Event::newClientTableEvent(
@@ -502,30 +792,33 @@ void ComputerClub::handleClientLeft(const Time &event_time,
         }
       }
     } else if (client_original_info.location == ClientLocation::IN_QUEUE) {
-      auto &queue = waiting_queue_state;
-      auto it = std::find(queue.begin(), queue.end(), client_name);
-      if (it != queue.end()) {
-        queue.erase(it);
-      }
+      waiting_queue_state.erase(client_name);
     }
   }
 }
 
+template <std::size_t MaxTables>
 std::optional<std::string>
-ComputerClub::processEventLine(const std::string &eventLine) {
+BasicComputerClub<MaxTables>::processEventLine(const std::string &eventLine) {
 
-  std::optional<ParsedEventInput> parsed_data = parseEventDetails(eventLine);
+  std::optional<EventInput> parsed_data = parseEventDetails(eventLine);
 
   if (!parsed_data.has_value()) {
     return eventLine;
   }
 
   const auto &data = parsed_data.value();
-  const Time &event_time = data.time;
-  int event_id_val = data.id;
-  const std::string &client_name_str = data.client_name;
-  int table_id_param = data.table_id;
+  this->processEvent(data.time, data.id, data.client_name, data.table_id);
+  return std::nullopt;
+}
 
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::processEvent(
+    const Time &event_time, int event_id_val,
+    const std::string &client_name_str, int table_id_param) {
+  // the handlers below mostly touch clients_in_club_state; the containers
+  // they call into tag their own allocations
+  MemoryScope memory_scope(MemorySubsystem::CLIENT_STATE);
   if (event_id_val == 2) {
     this->addEventToLog(Event::newClientTableEvent(
         event_time, event_id_val, client_name_str, table_id_param));
@@ -548,10 +841,38 @@ ComputerClub::processEventLine(const std::string &eventLine) {
     handleClientLeft(event_time, client_name_str);
     break;
   }
-  return std::nullopt;
+  occupancy_timeline.update(event_time.toMinutes(),
+                            tables_state.occupiedCount(),
+                            waiting_queue_state.size());
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::freeTable(int table_id,
+                                             const Time &current_time) {
+  SessionCharge session =
+      tables_state.free(table_id, current_time, hourly_rate_config);
+  revenue_total += session.revenue;
+  client_ledger.charge(session);
+  if (session.client_id != ClientRegistry::kNoClient) {
+    distributions.session_minutes.record(
+        static_cast<std::uint32_t>(session.minutes));
+  }
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::recordQueueWait(ClientInfo &client,
+                                                   const Time &seated_time) {
+  if (client.queued_minutes >= 0) {
+    int wait_minutes = seated_time.toMinutes() - client.queued_minutes;
+    distributions.queue_wait_minutes.record(
+        static_cast<std::uint32_t>(std::max(wait_minutes, 0)));
+    client.queued_minutes = -1;
+  }
 }
 
-void ComputerClub::processEndOfDay() {
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::processEndOfDay() {
+  MemoryScope memory_scope(MemorySubsystem::CLIENT_STATE);
   std::vector<std::string> remaining_clients_names;
   for (const auto &pair : clients_in_club_state) {
     remaining_clients_names.push_back(pair.first);
@@ -561,31 +882,243 @@ void ComputerClub::processEndOfDay() {
   for (const std::string &client_name : remaining_clients_names) {
     ClientInfo clientInfo = clients_in_club_state[client_name];
     if (clientInfo.table_id != 0) {
-      tables_state[clientInfo.table_id - 1].free(this->close_time_config,
-                                                 this->hourly_rate_config);
+      this->freeTable(clientInfo.table_id, this->close_time_config);
     }
     this->addEventToLog(
         Event::newClientEvent(this->close_time_config, 11, client_name));
   }
   clients_in_club_state.clear();
   waiting_queue_state.clear();
+  occupancy_timeline.update(this->close_time_config.toMinutes(),
+                            tables_state.occupiedCount(),
+                            waiting_queue_state.size());
+}
+
+template <std::size_t MaxTables>
+const Time &BasicComputerClub<MaxTables>::getOpenTime() const {
+  return open_time_config;
+}
+
+template <std::size_t MaxTables>
+const Time &BasicComputerClub<MaxTables>::getCloseTime() const {
+  return close_time_config;
 }
 
-const Time &ComputerClub::getOpenTime() const { return open_time_config; }
-const Time &ComputerClub::getCloseTime() const { return close_time_config; }
-const std::vector<Event> &ComputerClub::getEventLog() const {
+template <std::size_t MaxTables>
+ClubConfig BasicComputerClub<MaxTables>::getConfiguration() const {
+  return ClubConfig{num_tables_config, open_time_config, close_time_config,
+                    hourly_rate_config};
+}
+
+template <std::size_t MaxTables>
+TableInfo BasicComputerClub<MaxTables>::getTableInfo(int table_id) const {
+  TableInfo table(table_id);
+  table.is_occupied = tables_state.isOccupied(table_id);
+  if (table.is_occupied) {
+    table.current_client_name =
+        client_registry.name(tables_state.clientId(table_id));
+    table.session_start_time = tables_state.sessionStart(table_id);
+  }
+  table.total_minutes_used = tables_state.minutesUsed(table_id);
+  table.revenue_generated = tables_state.revenueGenerated(table_id);
+  return table;
+}
+
+template <std::size_t MaxTables>
+const std::vector<Event> &BasicComputerClub<MaxTables>::getEventLog() const {
   return event_log_output;
 }
 
-std::vector<std::string> ComputerClub::getTableStatistics() const {
+namespace {
+// "<id> <revenue> <HH:MM>" of one table, without the line break
+void formatTableStatistics(std::string &line, int table_id, int minutes_used,
+                           int revenue) {
+  // tables that were never used share one precomputed tail
+  static const std::string unused_table_tail = " 0 " + Time(0).toString();
+  line = std::to_string(table_id);
+  if (minutes_used == 0 && revenue == 0) {
+    line += unused_table_tail;
+  } else {
+    line += ' ';
+    line += std::to_string(revenue);
+    line += ' ';
+    line += Time(minutes_used).toString();
+  }
+}
+} // namespace
+
+template <std::size_t MaxTables>
+std::vector<std::string>
+BasicComputerClub<MaxTables>::getTableStatistics() const {
   std::vector<std::string> stats;
   stats.reserve(this->num_tables_config);
-  for (const auto &table : this->tables_state) {
-    Time duration_occupied(table.total_minutes_used);
-    std::ostringstream oss;
-    oss << table.id << " " << table.revenue_generated << " "
-        << duration_occupied.toString();
-    stats.push_back(oss.str());
-  }
+  this->tables_state.visitTotals(
+      [&stats](int table_id, int minutes_used, int revenue) {
+        std::string line;
+        formatTableStatistics(line, table_id, minutes_used, revenue);
+        stats.push_back(std::move(line));
+      });
   return stats;
-}
\ No newline at end of file
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::writeTableStatistics(
+    std::ostream &output) const {
+  // one line buffer for every table, nothing is kept per table
+  std::string line;
+  this->tables_state.visitTotals(
+      [&line, &output](int table_id, int minutes_used, int revenue) {
+        formatTableStatistics(line, table_id, minutes_used, revenue);
+        line += '\n';
+        output.write(line.data(), static_cast<std::streamsize>(line.size()));
+      });
+}
+
+template <std::size_t MaxTables>
+TableStatsSummary BasicComputerClub<MaxTables>::getTableTotals() const {
+  TableStatsSummary totals;
+  totals.minutes_used.resize(this->num_tables_config, 0);
+  totals.revenue.resize(this->num_tables_config, 0);
+  totals.days = 1;
+  totals.distributions = this->distributions;
+  this->tables_state.visitTotals(
+      [&totals](int table_id, int minutes_used, int revenue) {
+        totals.minutes_used[table_id - 1] = minutes_used;
+        totals.revenue[table_id - 1] = revenue;
+      });
+  return totals;
+}
+
+template <std::size_t MaxTables>
+ClientBill BasicComputerClub<MaxTables>::getClientBill(
+    const std::string &client_name) const {
+  ClientBill result =
+      client_ledger.bill(client_registry.find(client_name), client_registry);
+  result.client_name = client_name;
+  return result;
+}
+
+template <std::size_t MaxTables>
+std::vector<ClientBill>
+BasicComputerClub<MaxTables>::getTopSpenders(std::size_t count) const {
+  return client_ledger.topSpenders(count, client_registry);
+}
+
+template <std::size_t MaxTables>
+ClubLoad BasicComputerClub<MaxTables>::getLoad() const {
+  return ClubLoad{tables_state.occupiedCount(), waiting_queue_state.size(),
+                  clients_in_club_state.size(), revenue_total};
+}
+
+template <std::size_t MaxTables>
+std::size_t BasicComputerClub<MaxTables>::getSeatedClientCount() const {
+  return client_registry.size();
+}
+
+template <std::size_t MaxTables>
+const ClubDistributions &
+BasicComputerClub<MaxTables>::getDistributions() const {
+  return distributions;
+}
+
+template <std::size_t MaxTables>
+OccupancyCurve BasicComputerClub<MaxTables>::getOccupancyCurve() const {
+  return occupancy_timeline.curve(open_time_config.toMinutes(),
+                                  close_time_config.toMinutes());
+}
+
+template <std::size_t MaxTables>
+ClubStateSnapshot
+BasicComputerClub<MaxTables>::saveSnapshot(bool with_event_log) const {
+  ClubStateSnapshot snapshot;
+  snapshot.config = this->getConfiguration();
+  this->tables_state.visitUsed(
+      [this, &snapshot](int table_id, int minutes_used, int revenue) {
+        ClubStateSnapshot::TableState table;
+        table.table_id = table_id;
+        table.minutes_used = minutes_used;
+        table.revenue = revenue;
+        if (tables_state.isOccupied(table_id)) {
+          table.client_name =
+              client_registry.name(tables_state.clientId(table_id));
+          table.session_start = tables_state.sessionStart(table_id);
+        }
+        snapshot.tables.push_back(std::move(table));
+      });
+  for (const auto &[client_name, info] : clients_in_club_state) {
+    snapshot.clients.push_back({client_name, info.location, info.table_id});
+  }
+  waiting_queue_state.forEach([&snapshot](const std::string &client_name) {
+    snapshot.waiting_queue.push_back(client_name);
+  });
+  snapshot.bills = client_ledger.topSpenders(client_registry.size(),
+                                             client_registry);
+  snapshot.has_event_log = with_event_log;
+  if (with_event_log) {
+    snapshot.event_log = event_log_output;
+  }
+  return snapshot;
+}
+
+template <std::size_t MaxTables>
+ClubStateSnapshot BasicComputerClub<MaxTables>::saveOccupancySnapshot() const {
+  ClubStateSnapshot snapshot;
+  snapshot.config = this->getConfiguration();
+  this->tables_state.visitUsed([this, &snapshot](int table_id, int, int) {
+    if (tables_state.isOccupied(table_id)) {
+      ClubStateSnapshot::TableState table;
+      table.table_id = table_id;
+      table.client_name = client_registry.name(tables_state.clientId(table_id));
+      table.session_start = tables_state.sessionStart(table_id);
+      snapshot.tables.push_back(std::move(table));
+    }
+  });
+  for (const auto &[client_name, info] : clients_in_club_state) {
+    snapshot.clients.push_back({client_name, info.location, info.table_id});
+  }
+  waiting_queue_state.forEach([&snapshot](const std::string &client_name) {
+    snapshot.waiting_queue.push_back(client_name);
+  });
+  return snapshot;
+}
+
+template <std::size_t MaxTables>
+void BasicComputerClub<MaxTables>::restoreSnapshot(
+    const ClubStateSnapshot &snapshot) {
+  MemoryScope memory_scope(MemorySubsystem::CLIENT_STATE);
+  this->applyConfiguration(snapshot.config);
+  clients_in_club_state.clear();
+  {
+    MemoryScope event_log_scope(MemorySubsystem::EVENT_LOG);
+    event_log_output.clear();
+  }
+
+  for (const ClubStateSnapshot::TableState &table : snapshot.tables) {
+    tables_state.restoreTotals(table.table_id, table.minutes_used,
+                               table.revenue);
+    revenue_total += table.revenue;
+    if (!table.client_name.empty()) {
+      tables_state.occupy(table.table_id,
+                          client_registry.intern(table.client_name),
+                          table.session_start);
+    }
+  }
+  for (const ClubStateSnapshot::ClientState &client : snapshot.clients) {
+    clients_in_club_state[client.client_name] =
+        ClientInfo(client.location, client.table_id);
+  }
+  for (const std::string &client_name : snapshot.waiting_queue) {
+    waiting_queue_state.push_back(client_name);
+  }
+  for (const ClientBill &bill : snapshot.bills) {
+    client_ledger.restore(client_registry.intern(bill.client_name), bill);
+  }
+  if (snapshot.has_event_log) {
+    MemoryScope event_log_scope(MemorySubsystem::EVENT_LOG);
+    event_log_output = snapshot.event_log;
+  }
+}
+
+template class BasicComputerClub<kDynamicTables>;
+template class BasicComputerClub<kSparseTables>;
+template class BasicComputerClub<kSmallClubTables>;
@@ -1,16 +1,29 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <iomanip>
 #include <limits>
 #include <map>
 #include <optional>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
 #include <vector>
 
+#include "club_histogram.h"
+#include "club_memory.h"
+#include "club_timeline.h"
+
 namespace utils {
 int parsePositiveInteger(const std::string &s);
 bool isValidIntegerString(const std::string &s, int &out_val, int min_val,
@@ -18,6 +31,8 @@ bool isValidIntegerString(const std::string &s, int &out_val, int min_val,
 bool isValidClientName(const std::string &name);
 } // namespace utils
 
+enum class TimeParseStatus { OK, INVALID_FORMAT, NOT_A_NUMBER, INVALID_VALUE };
+
 // --- struct for time ---
 struct Time {
   int hours;
@@ -39,9 +54,33 @@ struct Time {
 
   int minutesUntil(const Time &futureTime) const;
   Time addMinutes(int mins_to_add) const;
+  // throws std::runtime_error, prefer tryParse on input-dependent paths
   static Time parse(const std::string &s);
+  // out is left untouched unless OK is returned
+  static TimeParseStatus tryParse(const std::string &s, Time &out) noexcept;
+};
+
+// --- configuration of club (first three lines of input) ---
+struct ClubConfig {
+  int num_tables = 0;
+  Time open_time;
+  Time close_time;
+  int hourly_rate = 0;
+};
+
+// --- parsed incoming event (ID 1-4) ---
+struct EventInput {
+  Time time;
+  int id = 0;
+  std::string client_name;
+  int table_id = 0;
 };
 
+std::optional<std::string> loadClubConfiguration(std::istream &configFileStream,
+                                                 ClubConfig &config);
+std::optional<EventInput> parseEventInput(const std::string &eventLine,
+                                          int num_tables);
+
 // --- struct for event ---
 struct Event {
 public:
@@ -66,7 +105,26 @@ public:
   std::string toString() const;
 };
 
+// --- per-table totals of one or many runs, mergeable without text ---
+struct TableStatsSummary {
+  // index is table id - 1
+  std::vector<std::int64_t> minutes_used;
+  std::vector<std::int64_t> revenue;
+  std::uint64_t days = 0;
+  ClubDistributions distributions;
+
+  int numTables() const;
+  // adds other to this, table count becomes the larger of the two
+  void merge(const TableStatsSummary &other);
+};
+
+// whole hours billed for a session, every started hour counts
+inline int billedHours(int duration_minutes) {
+  return (duration_minutes + 59) / 60;
+}
+
 // --- informatuion about table ---
+// standalone value type, also returned as a view of SoA table state
 struct TableInfo {
   int id;
   bool is_occupied = false;
@@ -87,33 +145,469 @@ enum class ClientLocation { INSIDE_CLUB_NOT_AT_TABLE, AT_TABLE, IN_QUEUE };
 struct ClientInfo {
   ClientLocation location;
   int table_id = 0;
+  // minutes of the time the client joined the queue, -1 if not queued or
+  // unknown (restored from a snapshot)
+  int queued_minutes = -1;
 
   ClientInfo(ClientLocation loc = ClientLocation::INSIDE_CLUB_NOT_AT_TABLE,
              int tblId = 0);
 };
 
+// --- interned client names, ids are dense and stable for the whole day ---
+class ClientRegistry {
+private:
+  std::deque<std::string> names; // deque keeps keys of ids stable
+  std::unordered_map<std::string_view, std::uint32_t> ids;
+
+public:
+  static constexpr std::uint32_t kNoClient = 0xFFFFFFFF;
+
+  std::uint32_t intern(const std::string &client_name);
+  std::uint32_t find(const std::string &client_name) const;
+  const std::string &name(std::uint32_t client_id) const;
+  std::size_t size() const;
+  void clear();
+};
+
+// --- one finished table session, returned by TableSet::free ---
+struct SessionCharge {
+  std::uint32_t client_id = ClientRegistry::kNoClient; // kNoClient: no session
+  int minutes = 0;
+  int billed_hours = 0;
+  int revenue = 0;
+};
+
+// --- per-client billing, indexed by ClientRegistry id ---
+struct ClientBill {
+  std::string client_name;
+  std::uint32_t sessions = 0;
+  std::uint32_t billed_hours = 0;
+  std::int64_t minutes = 0;
+  std::int64_t revenue = 0;
+};
+
+class ClientLedger {
+private:
+  std::vector<std::uint32_t> sessions;
+  std::vector<std::uint32_t> billed_hours;
+  std::vector<std::int64_t> minutes;
+  std::vector<std::int64_t> revenue;
+
+public:
+  void charge(const SessionCharge &session);
+  // clients that never finished a session have all zero totals
+  ClientBill bill(std::uint32_t client_id, const ClientRegistry &names) const;
+  // by revenue descending, then by name; clients with no sessions excluded
+  std::vector<ClientBill> topSpenders(std::size_t count,
+                                      const ClientRegistry &names) const;
+  // sets the totals of one client, used when a snapshot is restored
+  void restore(std::uint32_t client_id, const ClientBill &totals);
+  void clear();
+};
+
+// storage of tables and queue is chosen at compile time:
+// kDynamicTables - heap storage for any table count,
+// kSparseTables - table state created on first use, for huge table counts,
+// N - inline storage for clubs with at most N tables
+constexpr std::size_t kDynamicTables = 0;
+constexpr std::size_t kSparseTables = std::numeric_limits<std::size_t>::max();
+constexpr std::size_t kSmallClubTables = 64;
+// above this table count eager allocation costs more than it saves
+constexpr int kSparseTablesThreshold = 1 << 20;
+
+constexpr bool isInlineStorage(std::size_t max_tables) {
+  return max_tables != kDynamicTables && max_tables != kSparseTables;
+}
+
+// --- tables of club, addressed by 1-based table id ---
+// Structure of arrays: occupancy bitmap and session starts are the hot
+// part, totals are only touched when a session ends.
+template <std::size_t MaxTables> class TableSet {
+  static constexpr bool kDynamic = MaxTables == kDynamicTables;
+
+  template <typename T, std::size_t N>
+  using Column =
+      std::conditional_t<kDynamic, std::vector<T>, std::array<T, N>>;
+
+private:
+  Column<std::uint64_t, (MaxTables + 63) / 64> occupied_words;
+  Column<std::uint16_t, MaxTables> session_start_minutes;
+  Column<std::uint32_t, MaxTables> client_ids;
+  Column<int, MaxTables> minutes_used;
+  Column<int, MaxTables> revenue;
+  int count = 0;
+  int occupied_count = 0;
+
+  template <typename ColumnType, typename T>
+  static void resetColumn(ColumnType &column, std::size_t size, T value) {
+    if constexpr (kDynamic) {
+      column.assign(size, value);
+    } else {
+      column.fill(value);
+    }
+  }
+
+public:
+  void reset(int num_tables) {
+    MemoryScope memory_scope(MemorySubsystem::TABLE_STATE);
+    count = num_tables;
+    occupied_count = 0;
+    std::size_t size = static_cast<std::size_t>(num_tables);
+    resetColumn(occupied_words, (size + 63) / 64, std::uint64_t{0});
+    resetColumn(session_start_minutes, size, std::uint16_t{0});
+    resetColumn(client_ids, size, ClientRegistry::kNoClient);
+    resetColumn(minutes_used, size, 0);
+    resetColumn(revenue, size, 0);
+  }
+
+  int size() const { return count; }
+  int occupiedCount() const { return occupied_count; }
+  bool isOccupied(int table_id) const {
+    std::size_t index = table_id - 1;
+    return (occupied_words[index / 64] >> (index % 64)) & 1;
+  }
+  std::uint32_t clientId(int table_id) const {
+    return client_ids[table_id - 1];
+  }
+  Time sessionStart(int table_id) const {
+    return Time(session_start_minutes[table_id - 1]);
+  }
+  int minutesUsed(int table_id) const { return minutes_used[table_id - 1]; }
+  int revenueGenerated(int table_id) const { return revenue[table_id - 1]; }
+
+  void occupy(int table_id, std::uint32_t client_id,
+              const Time &current_time) {
+    std::size_t index = table_id - 1;
+    if (!isOccupied(table_id)) {
+      ++occupied_count;
+    }
+    occupied_words[index / 64] |= std::uint64_t{1} << (index % 64);
+    session_start_minutes[index] =
+        static_cast<std::uint16_t>(current_time.toMinutes());
+    client_ids[index] = client_id;
+  }
+
+  // same accounting as TableInfo::free
+  SessionCharge free(int table_id, const Time &current_time, int hour_price) {
+    SessionCharge session;
+    if (!isOccupied(table_id))
+      return session;
+    std::size_t index = table_id - 1;
+    int duration_minutes =
+        current_time.toMinutes() - session_start_minutes[index];
+    if (duration_minutes < 0) {
+      duration_minutes = 0;
+    }
+    session.client_id = client_ids[index];
+    session.minutes = duration_minutes;
+    session.billed_hours = billedHours(duration_minutes);
+    session.revenue = session.billed_hours * hour_price;
+    minutes_used[index] += session.minutes;
+    revenue[index] += session.revenue;
+
+    occupied_words[index / 64] &= ~(std::uint64_t{1} << (index % 64));
+    client_ids[index] = ClientRegistry::kNoClient;
+    --occupied_count;
+    return session;
+  }
+
+  // fn(table_id, minutes_used, revenue) for every table in id order
+  template <typename Fn> void visitTotals(Fn &&fn) const {
+    for (int table_id = 1; table_id <= count; ++table_id) {
+      fn(table_id, minutes_used[table_id - 1], revenue[table_id - 1]);
+    }
+  }
+
+  // fn(table_id, minutes_used, revenue) for tables that are occupied or
+  // have non-zero totals, in id order
+  template <typename Fn> void visitUsed(Fn &&fn) const {
+    for (int table_id = 1; table_id <= count; ++table_id) {
+      std::size_t index = table_id - 1;
+      if (isOccupied(table_id) || minutes_used[index] != 0 ||
+          revenue[index] != 0) {
+        fn(table_id, minutes_used[index], revenue[index]);
+      }
+    }
+  }
+
+  void restoreTotals(int table_id, int minutes, int table_revenue) {
+    minutes_used[table_id - 1] = minutes;
+    revenue[table_id - 1] = table_revenue;
+  }
+
+  int findFree() const {
+    if (occupied_count == count) {
+      return 0;
+    }
+    std::size_t num_words = (static_cast<std::size_t>(count) + 63) / 64;
+    for (std::size_t word = 0; word < num_words; ++word) {
+      std::uint64_t free_mask = ~occupied_words[word];
+      std::size_t tables_in_word = std::min<std::size_t>(64, count - word * 64);
+      if (tables_in_word < 64) {
+        free_mask &= (std::uint64_t{1} << tables_in_word) - 1;
+      }
+      if (free_mask != 0) {
+        return static_cast<int>(word * 64 + std::countr_zero(free_mask)) + 1;
+      }
+    }
+    return 0;
+  }
+};
+
+// Sparse variant: startup does not depend on the table count. Columns hold
+// only tables that were occupied at least once, other tables are free and
+// have zero totals.
+template <> class TableSet<kSparseTables> {
+private:
+  std::unordered_map<int, std::uint32_t> slot_of_table;
+  std::vector<int> table_ids;
+  std::vector<std::uint8_t> occupied;
+  std::vector<std::uint16_t> session_start_minutes;
+  std::vector<std::uint32_t> client_ids;
+  std::vector<int> minutes_used;
+  std::vector<int> revenue;
+  std::set<int> free_touched_tables;
+  int first_untouched_table = 1;
+  int count = 0;
+  int occupied_count = 0;
+
+  std::uint32_t findSlot(int table_id) const {
+    auto it = slot_of_table.find(table_id);
+    return it == slot_of_table.end() ? ClientRegistry::kNoClient : it->second;
+  }
+  std::uint32_t touch(int table_id);
+
+public:
+  void reset(int num_tables);
+
+  int size() const { return count; }
+  int occupiedCount() const { return occupied_count; }
+  bool isOccupied(int table_id) const {
+    std::uint32_t slot = findSlot(table_id);
+    return slot != ClientRegistry::kNoClient && occupied[slot];
+  }
+  std::uint32_t clientId(int table_id) const {
+    std::uint32_t slot = findSlot(table_id);
+    return slot == ClientRegistry::kNoClient ? ClientRegistry::kNoClient
+                                             : client_ids[slot];
+  }
+  Time sessionStart(int table_id) const {
+    std::uint32_t slot = findSlot(table_id);
+    return slot == ClientRegistry::kNoClient
+               ? Time()
+               : Time(session_start_minutes[slot]);
+  }
+  int minutesUsed(int table_id) const {
+    std::uint32_t slot = findSlot(table_id);
+    return slot == ClientRegistry::kNoClient ? 0 : minutes_used[slot];
+  }
+  int revenueGenerated(int table_id) const {
+    std::uint32_t slot = findSlot(table_id);
+    return slot == ClientRegistry::kNoClient ? 0 : revenue[slot];
+  }
+
+  void occupy(int table_id, std::uint32_t client_id, const Time &current_time);
+  SessionCharge free(int table_id, const Time &current_time, int hour_price);
+  int findFree() const;
+  void restoreTotals(int table_id, int minutes, int table_revenue);
+
+  template <typename Fn> void visitUsed(Fn &&fn) const {
+    std::vector<std::uint32_t> slots;
+    for (std::uint32_t slot = 0; slot < table_ids.size(); ++slot) {
+      if (occupied[slot] || minutes_used[slot] != 0 || revenue[slot] != 0) {
+        slots.push_back(slot);
+      }
+    }
+    std::sort(slots.begin(), slots.end(),
+              [this](std::uint32_t a, std::uint32_t b) {
+                return table_ids[a] < table_ids[b];
+              });
+    for (std::uint32_t slot : slots) {
+      fn(table_ids[slot], minutes_used[slot], revenue[slot]);
+    }
+  }
+
+  template <typename Fn> void visitTotals(Fn &&fn) const {
+    std::vector<std::uint32_t> slots_by_id(table_ids.size());
+    for (std::uint32_t slot = 0; slot < slots_by_id.size(); ++slot) {
+      slots_by_id[slot] = slot;
+    }
+    std::sort(slots_by_id.begin(), slots_by_id.end(),
+              [this](std::uint32_t a, std::uint32_t b) {
+                return table_ids[a] < table_ids[b];
+              });
+    auto next = slots_by_id.begin();
+    for (int table_id = 1; table_id <= count; ++table_id) {
+      if (next != slots_by_id.end() && table_ids[*next] == table_id) {
+        fn(table_id, minutes_used[*next], revenue[*next]);
+        ++next;
+      } else {
+        fn(table_id, 0, 0);
+      }
+    }
+  }
+};
+
+// --- queue of waiting clients, never longer than table count ---
+template <std::size_t Capacity, bool Inline = isInlineStorage(Capacity)>
+class WaitingQueue {
+private:
+  std::array<std::string, Capacity> slots;
+  std::size_t head = 0;
+  std::size_t length = 0;
+
+  std::string &at(std::size_t pos) { return slots[(head + pos) % Capacity]; }
+  const std::string &at(std::size_t pos) const {
+    return slots[(head + pos) % Capacity];
+  }
+
+public:
+  std::size_t size() const { return length; }
+  bool empty() const { return length == 0; }
+  const std::string &front() const { return slots[head]; }
+
+  void push_back(const std::string &client_name) {
+    MemoryScope memory_scope(MemorySubsystem::QUEUE);
+    at(length) = client_name;
+    ++length;
+  }
+  void pop_front() {
+    slots[head].clear();
+    head = (head + 1) % Capacity;
+    --length;
+  }
+  bool contains(const std::string &client_name) const {
+    for (std::size_t i = 0; i < length; ++i) {
+      if (at(i) == client_name) {
+        return true;
+      }
+    }
+    return false;
+  }
+  void erase(const std::string &client_name) {
+    std::size_t pos = 0;
+    while (pos < length && at(pos) != client_name) {
+      ++pos;
+    }
+    if (pos == length) {
+      return;
+    }
+    for (; pos + 1 < length; ++pos) {
+      at(pos) = std::move(at(pos + 1));
+    }
+    at(length - 1).clear();
+    --length;
+  }
+  void clear() {
+    for (std::size_t i = 0; i < length; ++i) {
+      at(i).clear();
+    }
+    head = 0;
+    length = 0;
+  }
+  // fn(client_name) from front to back
+  template <typename Fn> void forEach(Fn &&fn) const {
+    for (std::size_t i = 0; i < length; ++i) {
+      fn(at(i));
+    }
+  }
+};
+
+template <std::size_t Capacity> class WaitingQueue<Capacity, false> {
+private:
+  std::deque<std::string> clients;
+
+public:
+  std::size_t size() const { return clients.size(); }
+  bool empty() const { return clients.empty(); }
+  const std::string &front() const { return clients.front(); }
+
+  void push_back(const std::string &client_name) {
+    MemoryScope memory_scope(MemorySubsystem::QUEUE);
+    clients.push_back(client_name);
+  }
+  void pop_front() {
+    MemoryScope memory_scope(MemorySubsystem::QUEUE);
+    clients.pop_front();
+  }
+  bool contains(const std::string &client_name) const {
+    return std::find(clients.begin(), clients.end(), client_name) !=
+           clients.end();
+  }
+  void erase(const std::string &client_name) {
+    auto it = std::find(clients.begin(), clients.end(), client_name);
+    if (it != clients.end()) {
+      MemoryScope memory_scope(MemorySubsystem::QUEUE);
+      clients.erase(it);
+    }
+  }
+  void clear() {
+    MemoryScope memory_scope(MemorySubsystem::QUEUE);
+    clients.clear();
+  }
+  template <typename Fn> void forEach(Fn &&fn) const {
+    for (const std::string &client_name : clients) {
+      fn(client_name);
+    }
+  }
+};
+
+// --- live load of a club, cheap enough to read after every event ---
+struct ClubLoad {
+  int occupied_tables = 0;
+  std::size_t queue_length = 0;
+  std::size_t clients_inside = 0;
+  // revenue of finished sessions so far
+  std::int64_t revenue = 0;
+};
+
+// --- full state of a club between two events, independent of storage ---
+struct ClubStateSnapshot {
+  struct TableState {
+    int table_id = 0;
+    int minutes_used = 0;
+    int revenue = 0;
+    std::string client_name; // empty for a free table
+    Time session_start;
+  };
+  struct ClientState {
+    std::string client_name;
+    ClientLocation location = ClientLocation::INSIDE_CLUB_NOT_AT_TABLE;
+    int table_id = 0;
+  };
+
+  ClubConfig config;
+  // tables that are occupied or have non-zero totals, by id
+  std::vector<TableState> tables;
+  // clients inside the club, by name
+  std::vector<ClientState> clients;
+  std::vector<std::string> waiting_queue;
+  // clients with at least one finished session
+  std::vector<ClientBill> bills;
+  bool has_event_log = false;
+  std::vector<Event> event_log;
+};
+
 // --- main class computer club ---
-class ComputerClub {
+template <std::size_t MaxTables> class BasicComputerClub {
 private:
   int num_tables_config = 0;
   Time open_time_config;
   Time close_time_config;
   int hourly_rate_config = 0;
 
-  std::vector<TableInfo> tables_state;
+  ClientRegistry client_registry;
+  ClientLedger client_ledger;
+  std::int64_t revenue_total = 0;
+  ClubDistributions distributions;
+  OccupancyTimeline occupancy_timeline;
+  TableSet<MaxTables> tables_state;
   std::map<std::string, ClientInfo> clients_in_club_state;
-  std::deque<std::string> waiting_queue_state;
+  WaitingQueue<MaxTables> waiting_queue_state;
 
   std::vector<Event> event_log_output;
 
-  struct ParsedEventInput {
-    Time time;
-    int id;
-    std::string client_name;
-    int table_id = 0;
-  };
-  std::optional<ParsedEventInput>
-  parseEventDetails(const std::string &eventLine);
+  std::optional<EventInput> parseEventDetails(const std::string &eventLine);
 
   void handleClientArrived(const Time &event_time,
                            const std::string &client_name);
@@ -129,18 +623,102 @@ private:
   bool isClientInClub(const std::string &client_name) const;
   bool isWorkingTime(const Time &current_time) const;
   int findFreeTable() const;
+  // ends the session at table_id and bills it to the table and the client
+  void freeTable(int table_id, const Time &current_time);
+  // wait of a client seated from the queue (ID 12)
+  void recordQueueWait(ClientInfo &client, const Time &seated_time);
 
 public:
-  ComputerClub();
+  BasicComputerClub();
 
   std::optional<std::string> loadConfiguration(std::istream &configFileStream);
+  // config.num_tables must not exceed MaxTables for inline storage
+  void applyConfiguration(const ClubConfig &config);
   std::optional<std::string> processEventLine(const std::string &eventLine);
+  // already validated event (binary input), skips text parsing
+  void processEvent(const Time &event_time, int event_id,
+                    const std::string &client_name, int table_id = 0);
   void processEndOfDay();
 
   const Time &getOpenTime() const;
   const Time &getCloseTime() const;
+  ClubConfig getConfiguration() const;
+  // snapshot of one table in TableInfo form
+  TableInfo getTableInfo(int table_id) const;
   const std::vector<Event> &getEventLog() const;
   std::vector<std::string> getTableStatistics() const;
+  // the same lines streamed to output, without a string per table
+  void writeTableStatistics(std::ostream &output) const;
+  // numeric form of getTableStatistics, counts as one day
+  TableStatsSummary getTableTotals() const;
+  // billing of finished sessions, kept up to date as sessions end
+  ClientBill getClientBill(const std::string &client_name) const;
+  std::vector<ClientBill> getTopSpenders(std::size_t count) const;
+  ClubLoad getLoad() const;
+  // distinct clients that have taken a table since the configuration
+  std::size_t getSeatedClientCount() const;
+  // session lengths and queue waits so far; sessions still running are not
+  // included until they end
+  const ClubDistributions &getDistributions() const;
+  // occupied tables and queue length per minute of the working hours, a
+  // prefix-sum pass over the timeline; after restoreSnapshot the restored
+  // state counts from the minute of the next event
+  OccupancyCurve getOccupancyCurve() const;
+
+  // The event log grows with the day, so it is only copied on request.
+  ClubStateSnapshot saveSnapshot(bool with_event_log = false) const;
+  // Who sits where and who waits: occupied tables with zero totals, clients
+  // inside and the queue, no bills. Its size follows the club's current
+  // occupancy, not the number of clients seen so far in the day.
+  ClubStateSnapshot saveOccupancySnapshot() const;
+  // snapshot.config.num_tables must fit the storage, like applyConfiguration
+  void restoreSnapshot(const ClubStateSnapshot &snapshot);
 };
 
+extern template class BasicComputerClub<kDynamicTables>;
+extern template class BasicComputerClub<kSparseTables>;
+extern template class BasicComputerClub<kSmallClubTables>;
+
+using ComputerClub = BasicComputerClub<kDynamicTables>;
+using SparseComputerClub = BasicComputerClub<kSparseTables>;
+using SmallComputerClub = BasicComputerClub<kSmallClubTables>;
+
+// Calls fn with the engine variant best suited for config, already
+// configured. Clubs up to kSmallClubTables tables get inline storage,
+// clubs above kSparseTablesThreshold get lazily created table state.
+template <typename Fn>
+decltype(auto) withClubEngine(const ClubConfig &config, Fn &&fn) {
+  if (config.num_tables <= static_cast<int>(kSmallClubTables)) {
+    SmallComputerClub club;
+    club.applyConfiguration(config);
+    return fn(club);
+  }
+  if (config.num_tables > kSparseTablesThreshold) {
+    SparseComputerClub club;
+    club.applyConfiguration(config);
+    return fn(club);
+  }
+  ComputerClub club;
+  club.applyConfiguration(config);
+  return fn(club);
+}
+
+// Engine kept alive across calls (stream drivers), same choice of variant
+// as withClubEngine. Use std::visit to reach the engine.
+using AnyComputerClub =
+    std::variant<SmallComputerClub, ComputerClub, SparseComputerClub>;
+
+inline void emplaceClubEngine(AnyComputerClub &club,
+                              const ClubConfig &config) {
+  if (config.num_tables <= static_cast<int>(kSmallClubTables)) {
+    club.emplace<SmallComputerClub>();
+  } else if (config.num_tables > kSparseTablesThreshold) {
+    club.emplace<SparseComputerClub>();
+  } else {
+    club.emplace<ComputerClub>();
+  }
+  std::visit([&config](auto &engine) { engine.applyConfiguration(config); },
+             club);
+}
+
 bool isValidClientName(const std::string &name);
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include "event_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+
+#include "binary_format.h"
+#include "club_runner.h"
+
+namespace event_archive {
+namespace {
+
+using binary_format::readBytes;
+using binary_format::readVarint;
+using binary_format::writeBytes;
+using binary_format::writeVarint;
+
+constexpr std::size_t kHeaderSize = sizeof(kMagic) + 1;
+constexpr std::size_t kTrailerOffsetSize = 8;
+
+constexpr const char *kErrorMessages[] = {
+    "", "YouShallNotPass", "NotOpenYet", "PlaceIsBusy", "ClientUnknown",
+    "ICanWaitNoLonger!"};
+
+} // namespace
+
+ErrorCode errorCodeOf(const std::string &message) {
+  for (std::size_t code = 1; code < std::size(kErrorMessages); ++code) {
+    if (message == kErrorMessages[code]) {
+      return static_cast<ErrorCode>(code);
+    }
+  }
+  return ErrorCode::OTHER;
+}
+
+const char *errorMessageOf(ErrorCode code) {
+  std::size_t index = static_cast<std::size_t>(code);
+  return index < std::size(kErrorMessages) ? kErrorMessages[index] : "";
+}
+
+// --- class Writer ---
+Writer::Writer(std::size_t max_events_per_block)
+    : data(kMagic, sizeof(kMagic)),
+      events_per_block(max_events_per_block == 0 ? 1 : max_events_per_block) {
+  data.push_back(static_cast<char>(kVersion));
+}
+
+void Writer::append(const Event &event) {
+  int minutes = event.event_time.toMinutes();
+  // times of a log never go back, but a new block keeps any order exact
+  if (blocks.empty() || blocks.back().num_events == events_per_block ||
+      minutes < last_minutes) {
+    blocks.push_back({data.size(), 0, event.event_time});
+    last_minutes = 0;
+  }
+  ++blocks.back().num_events;
+
+  writeVarint(data, static_cast<std::uint64_t>(event.event_id));
+  writeVarint(data, minutes - last_minutes);
+  last_minutes = minutes;
+
+  if (event.event_id == 13) {
+    ErrorCode code = errorCodeOf(event.error_message);
+    data.push_back(static_cast<char>(code));
+    if (code == ErrorCode::OTHER) {
+      writeBytes(data, event.error_message);
+    }
+    return;
+  }
+
+  std::uint64_t client = 0;
+  if (!event.client_name.empty()) {
+    auto [it, inserted] = name_to_index.try_emplace(
+        event.client_name, static_cast<std::uint32_t>(names.size()));
+    if (inserted) {
+      names.push_back(&it->first);
+    }
+    client = it->second + 1;
+  }
+  writeVarint(data, client);
+  writeVarint(data, static_cast<std::uint64_t>(event.table_id_val));
+}
+
+std::string Writer::finish() {
+  std::uint64_t trailer_offset = data.size();
+  writeVarint(data, names.size());
+  for (const std::string *name : names) {
+    writeBytes(data, *name);
+  }
+  writeVarint(data, blocks.size());
+  for (const BlockInfo &block : blocks) {
+    writeVarint(data, block.offset);
+    writeVarint(data, block.num_events);
+    writeVarint(data, block.first_time.toMinutes());
+  }
+  for (std::size_t i = 0; i < kTrailerOffsetSize; ++i) {
+    data.push_back(static_cast<char>((trailer_offset >> (8 * i)) & 0xFF));
+  }
+
+  std::string image = std::move(data);
+  *this = Writer(events_per_block);
+  return image;
+}
+
+std::string writeArchive(const std::vector<Event> &event_log,
+                         std::size_t events_per_block) {
+  Writer writer(events_per_block);
+  for (const Event &event : event_log) {
+    writer.append(event);
+  }
+  return writer.finish();
+}
+
+// --- class Reader ---
+std::optional<std::string> Reader::open(const std::string &data) {
+  dictionary.clear();
+  blocks.clear();
+  block_starts.clear();
+  total_events = 0;
+
+  if (data.size() < kHeaderSize + kTrailerOffsetSize ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return "not an event log archive";
+  }
+  begin = reinterpret_cast<const std::uint8_t *>(data.data());
+  if (begin[sizeof(kMagic)] != kVersion) {
+    return "unsupported event log archive version";
+  }
+
+  const std::uint8_t *end = begin + data.size() - kTrailerOffsetSize;
+  std::uint64_t trailer_offset = 0;
+  for (std::size_t i = 0; i < kTrailerOffsetSize; ++i) {
+    trailer_offset |= static_cast<std::uint64_t>(end[i]) << (8 * i);
+  }
+  if (trailer_offset < kHeaderSize ||
+      trailer_offset > static_cast<std::uint64_t>(end - begin)) {
+    return "invalid trailer offset";
+  }
+  trailer = begin + trailer_offset;
+
+  const std::uint8_t *cursor = trailer;
+  std::uint64_t dictionary_size;
+  if (!readVarint(cursor, end, dictionary_size) ||
+      dictionary_size > static_cast<std::uint64_t>(end - cursor)) {
+    return "truncated dictionary";
+  }
+  dictionary.resize(dictionary_size);
+  for (std::string &name : dictionary) {
+    if (!readBytes(cursor, end, name)) {
+      return "truncated dictionary";
+    }
+  }
+
+  std::uint64_t block_count;
+  if (!readVarint(cursor, end, block_count) ||
+      block_count > static_cast<std::uint64_t>(end - cursor)) {
+    return "truncated block index";
+  }
+  blocks.resize(block_count);
+  std::uint64_t previous_offset = kHeaderSize;
+  for (BlockInfo &block : blocks) {
+    std::uint64_t num_events, first_minutes;
+    if (!readVarint(cursor, end, block.offset) ||
+        !readVarint(cursor, end, num_events) ||
+        !readVarint(cursor, end, first_minutes)) {
+      return "truncated block index";
+    }
+    if (block.offset < previous_offset || block.offset > trailer_offset ||
+        num_events == 0 || num_events > UINT32_MAX ||
+        first_minutes >= 24 * 60) {
+      return "invalid block index";
+    }
+    previous_offset = block.offset;
+    block.num_events = static_cast<std::uint32_t>(num_events);
+    block.first_time = Time(static_cast<int>(first_minutes));
+    block_starts.push_back(total_events);
+    total_events += num_events;
+  }
+  if (cursor != end) {
+    return "trailing bytes after block index";
+  }
+  return std::nullopt;
+}
+
+const std::vector<std::string> &Reader::getDictionary() const {
+  return dictionary;
+}
+
+const std::vector<BlockInfo> &Reader::getBlocks() const { return blocks; }
+
+std::uint64_t Reader::size() const { return total_events; }
+
+std::optional<std::string> Reader::readBlock(std::size_t index,
+                                             std::vector<Event> &out) const {
+  if (index >= blocks.size()) {
+    return "block index out of range";
+  }
+  const std::uint8_t *cursor = begin + blocks[index].offset;
+  const std::uint8_t *end =
+      index + 1 < blocks.size() ? begin + blocks[index + 1].offset : trailer;
+
+  int minutes = 0;
+  std::string message;
+  for (std::uint32_t i = 0; i < blocks[index].num_events; ++i) {
+    std::uint64_t event_id, delta;
+    if (!readVarint(cursor, end, event_id) ||
+        !readVarint(cursor, end, delta)) {
+      return "truncated record";
+    }
+    if (event_id > 13 || delta >= 24 * 60 ||
+        minutes + static_cast<int>(delta) >= 24 * 60) {
+      return "invalid record";
+    }
+    minutes += static_cast<int>(delta);
+    Time time(minutes);
+
+    if (event_id == 13) {
+      if (cursor == end) {
+        return "truncated record";
+      }
+      std::uint8_t code = *cursor++;
+      if (code >= std::size(kErrorMessages)) {
+        return "unknown error code";
+      }
+      if (code == static_cast<std::uint8_t>(ErrorCode::OTHER)) {
+        if (!readBytes(cursor, end, message)) {
+          return "truncated record";
+        }
+        out.push_back(Event::newErrorEvent(time, message));
+      } else {
+        out.push_back(Event::newErrorEvent(time, kErrorMessages[code]));
+      }
+      continue;
+    }
+
+    std::uint64_t client, table_id;
+    if (!readVarint(cursor, end, client) ||
+        !readVarint(cursor, end, table_id)) {
+      return "truncated record";
+    }
+    if (client > dictionary.size() || table_id > INT32_MAX) {
+      return "invalid record";
+    }
+    const std::string &name = client == 0 ? "" : dictionary[client - 1];
+    out.push_back(Event::newClientTableEvent(time, static_cast<int>(event_id),
+                                             name,
+                                             static_cast<int>(table_id)));
+  }
+  if (cursor != end) {
+    return "trailing bytes in block";
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> Reader::readAll(std::vector<Event> &out) const {
+  out.reserve(out.size() + total_events);
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    std::optional<std::string> error = readBlock(i, out);
+    if (error.has_value()) {
+      return error;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string>
+Reader::readEvents(const std::vector<std::uint32_t> &positions,
+                   std::vector<Event> &out) const {
+  std::vector<Event> block_events;
+  std::size_t loaded_block = blocks.size();
+  for (std::uint32_t position : positions) {
+    if (position >= total_events) {
+      return "event position out of range";
+    }
+    std::size_t block = static_cast<std::size_t>(
+        std::upper_bound(block_starts.begin(), block_starts.end(), position) -
+        block_starts.begin() - 1);
+    if (block != loaded_block) {
+      block_events.clear();
+      std::optional<std::string> error = readBlock(block, block_events);
+      if (error.has_value()) {
+        return error;
+      }
+      loaded_block = block;
+    }
+    out.push_back(block_events[position - block_starts[block]]);
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> archiveDayLog(std::istream &text_input,
+                                         std::ostream &archive_output) {
+  std::optional<std::vector<Event>> event_log = collectEventLog(text_input);
+  if (!event_log.has_value()) {
+    return "input has a rejected configuration or event line";
+  }
+  std::string image = writeArchive(event_log.value());
+  archive_output.write(image.data(), image.size());
+  if (!archive_output) {
+    return "write error";
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> decompressToText(std::istream &archive_input,
+                                            std::ostream &text_output) {
+  std::string data((std::istreambuf_iterator<char>(archive_input)),
+                   std::istreambuf_iterator<char>());
+  Reader reader;
+  std::optional<std::string> error = reader.open(data);
+  if (error.has_value()) {
+    return error;
+  }
+
+  // one block at a time keeps memory bounded by the block size
+  std::vector<Event> events;
+  for (std::size_t i = 0; i < reader.getBlocks().size(); ++i) {
+    events.clear();
+    error = reader.readBlock(i, events);
+    if (error.has_value()) {
+      return error;
+    }
+    for (const Event &event : events) {
+      text_output << event.toString() << '\n';
+    }
+  }
+  if (!text_output) {
+    return "write error";
+  }
+  return std::nullopt;
+}
+
+} // namespace event_archive
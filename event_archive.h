@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "computer_club.h"
+
+// Compact archive of an output event log (the lines of getEventLog()).
+//
+// Layout (version 1, all integers are LEB128 varints unless noted):
+//   "CCLA" magic, u8 version
+//   blocks of records; a record is
+//     event id, time delta from the previous record of the same block
+//     (the first record of a block stores minutes since midnight),
+//     then for id 13: error code, and for code 0 also length + message,
+//     otherwise: client index + 1 (0 = no client), table id (0 = none)
+//   trailer: dictionary count, then length + bytes per client name;
+//     block count, then per block: file offset, event count, first minute
+//   u64 little-endian file offset of the trailer
+//
+// A block only needs the dictionary to be decoded, so any block can be read
+// without touching the ones before it.
+namespace event_archive {
+
+constexpr char kMagic[4] = {'C', 'C', 'L', 'A'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kDefaultEventsPerBlock = 4096;
+
+// messages of event 13 the engine produces
+enum class ErrorCode : std::uint8_t {
+  OTHER = 0,
+  YOU_SHALL_NOT_PASS,
+  NOT_OPEN_YET,
+  PLACE_IS_BUSY,
+  CLIENT_UNKNOWN,
+  I_CAN_WAIT_NO_LONGER,
+};
+
+ErrorCode errorCodeOf(const std::string &message);
+// empty for OTHER
+const char *errorMessageOf(ErrorCode code);
+
+struct BlockInfo {
+  std::uint64_t offset = 0;
+  std::uint32_t num_events = 0;
+  Time first_time;
+};
+
+class Writer {
+private:
+  std::string data;
+  std::unordered_map<std::string, std::uint32_t> name_to_index;
+  std::vector<const std::string *> names;
+  std::vector<BlockInfo> blocks;
+  std::size_t events_per_block;
+  int last_minutes = 0;
+
+public:
+  explicit Writer(std::size_t max_events_per_block = kDefaultEventsPerBlock);
+
+  void append(const Event &event);
+  // returns the file image; the writer is empty afterwards
+  std::string finish();
+};
+
+std::string writeArchive(const std::vector<Event> &event_log,
+                         std::size_t events_per_block = kDefaultEventsPerBlock);
+
+// --- decoder over an in-memory file image ---
+class Reader {
+private:
+  const std::uint8_t *begin = nullptr;
+  const std::uint8_t *trailer = nullptr;
+  std::vector<std::string> dictionary;
+  std::vector<BlockInfo> blocks;
+  // position of the first event of each block
+  std::vector<std::uint64_t> block_starts;
+  std::uint64_t total_events = 0;
+
+public:
+  // returns error description on malformed file; data must outlive reader
+  std::optional<std::string> open(const std::string &data);
+
+  const std::vector<std::string> &getDictionary() const;
+  const std::vector<BlockInfo> &getBlocks() const;
+  std::uint64_t size() const;
+
+  // appends the events of one block or of the whole file to out
+  std::optional<std::string> readBlock(std::size_t index,
+                                       std::vector<Event> &out) const;
+  std::optional<std::string> readAll(std::vector<Event> &out) const;
+  // appends the events at ascending positions, decoding only the blocks
+  // that hold them
+  std::optional<std::string>
+  readEvents(const std::vector<std::uint32_t> &positions,
+             std::vector<Event> &out) const;
+};
+
+// Runs a text input and archives the event log of the day. Fails for
+// inputs on which task stops early, as they have no event log in output.
+std::optional<std::string> archiveDayLog(std::istream &text_input,
+                                         std::ostream &archive_output);
+// writes the log back in the task output format, one event per line
+std::optional<std::string> decompressToText(std::istream &archive_input,
+                                            std::ostream &text_output);
+
+} // namespace event_archive
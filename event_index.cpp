@@ -0,0 +1,283 @@
+#include "event_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "binary_format.h"
+
+namespace {
+
+using binary_format::readBytes;
+using binary_format::readVarint;
+using binary_format::writeBytes;
+using binary_format::writeVarint;
+
+const EventLogIndex::Postings kNoEvents;
+
+void writePostings(std::string &out, const EventLogIndex::Postings &list) {
+  writeVarint(out, list.size());
+  std::uint32_t previous = 0;
+  for (std::uint32_t position : list) {
+    writeVarint(out, position - previous);
+    previous = position;
+  }
+}
+
+bool readPostings(const std::uint8_t *&cursor, const std::uint8_t *end,
+                  std::uint32_t num_events, EventLogIndex::Postings &list) {
+  std::uint64_t count;
+  if (!readVarint(cursor, end, count) || count > num_events) {
+    return false;
+  }
+  list.resize(count);
+  std::uint64_t position = 0;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::uint64_t delta;
+    if (!readVarint(cursor, end, delta) || (i > 0 && delta == 0)) {
+      return false;
+    }
+    position += delta;
+    if (position >= num_events) {
+      return false;
+    }
+    list[i] = static_cast<std::uint32_t>(position);
+  }
+  return true;
+}
+
+} // namespace
+
+// --- class EventLogIndex ---
+EventLogIndex::EventLogIndex() : minute_starts(kMinutesPerDay + 1, 0) {}
+
+EventLogIndex::Postings &
+EventLogIndex::postingsOfClient(const std::string &client_name) {
+  std::uint32_t client_id = client_registry.intern(client_name);
+  if (client_id == client_postings.size()) {
+    client_postings.emplace_back();
+  }
+  return client_postings[client_id];
+}
+
+std::uint32_t EventLogIndex::minuteStart(int minute) const {
+  return minute <= last_minute ? minute_starts[minute] : num_events;
+}
+
+void EventLogIndex::append(const Event &event) {
+  std::uint32_t position = num_events++;
+  int minute = event.event_time.toMinutes();
+  if (minute < last_minute) {
+    late_events.push_back({position, minute});
+  }
+  for (; last_minute < minute; ++last_minute) {
+    minute_starts[last_minute + 1] = position;
+  }
+
+  if (!event.client_name.empty()) {
+    postingsOfClient(event.client_name).push_back(position);
+  }
+  if (event.table_id_val != 0) {
+    table_postings[event.table_id_val].push_back(position);
+  }
+}
+
+void EventLogIndex::catchUp(const std::vector<Event> &event_log) {
+  for (std::size_t i = num_events; i < event_log.size(); ++i) {
+    append(event_log[i]);
+  }
+}
+
+void EventLogIndex::clear() { *this = EventLogIndex(); }
+
+std::size_t EventLogIndex::size() const { return num_events; }
+
+const EventLogIndex::Postings &
+EventLogIndex::clientEvents(const std::string &client_name) const {
+  std::uint32_t client_id = client_registry.find(client_name);
+  return client_id == ClientRegistry::kNoClient ? kNoEvents
+                                                : client_postings[client_id];
+}
+
+const EventLogIndex::Postings &EventLogIndex::tableEvents(int table_id) const {
+  auto it = table_postings.find(table_id);
+  return it == table_postings.end() ? kNoEvents : it->second;
+}
+
+EventLogIndex::Postings EventLogIndex::timeRange(const Time &from,
+                                                 const Time &to) const {
+  int first_minute = std::max(from.toMinutes(), 0);
+  int end_minute = std::min(to.toMinutes() + 1, kMinutesPerDay);
+  Postings positions;
+  if (first_minute >= end_minute) {
+    return positions;
+  }
+  std::uint32_t first = minuteStart(first_minute);
+  std::uint32_t last = minuteStart(end_minute);
+  positions.reserve(last - first);
+  // late events inside the in-order run belong to earlier minutes, late
+  // events of the requested minutes are merged in by position
+  auto late = late_events.begin();
+  for (std::uint32_t position = first; position < last; ++position) {
+    for (; late != late_events.end() && late->position < position; ++late) {
+      if (late->minute >= first_minute && late->minute < end_minute) {
+        positions.push_back(late->position);
+      }
+    }
+    if (late != late_events.end() && late->position == position) {
+      continue;
+    }
+    positions.push_back(position);
+  }
+  for (; late != late_events.end(); ++late) {
+    if (late->minute >= first_minute && late->minute < end_minute) {
+      positions.push_back(late->position);
+    }
+  }
+  return positions;
+}
+
+std::string EventLogIndex::serialize() const {
+  std::string out(kMagic, sizeof(kMagic));
+  out.push_back(static_cast<char>(kVersion));
+  writeVarint(out, num_events);
+
+  writeVarint(out, client_postings.size());
+  for (std::uint32_t id = 0; id < client_postings.size(); ++id) {
+    writeBytes(out, client_registry.name(id));
+    writePostings(out, client_postings[id]);
+  }
+
+  // tables in id order so equal indexes serialize to equal bytes
+  std::vector<int> table_ids;
+  table_ids.reserve(table_postings.size());
+  for (const auto &entry : table_postings) {
+    table_ids.push_back(entry.first);
+  }
+  std::sort(table_ids.begin(), table_ids.end());
+  writeVarint(out, table_ids.size());
+  for (int table_id : table_ids) {
+    writeVarint(out, table_id);
+    writePostings(out, table_postings.at(table_id));
+  }
+
+  writeVarint(out, last_minute);
+  for (int minute = 1; minute <= last_minute; ++minute) {
+    writeVarint(out, minute_starts[minute] - minute_starts[minute - 1]);
+  }
+
+  writeVarint(out, late_events.size());
+  std::uint32_t previous = 0;
+  for (const LateEvent &late : late_events) {
+    writeVarint(out, late.position - previous);
+    writeVarint(out, late.minute);
+    previous = late.position;
+  }
+  return out;
+}
+
+std::optional<std::string>
+EventLogIndex::deserialize(const std::string &data) {
+  clear();
+  const std::uint8_t *cursor =
+      reinterpret_cast<const std::uint8_t *>(data.data());
+  const std::uint8_t *end = cursor + data.size();
+  if (data.size() < sizeof(kMagic) + 1 ||
+      std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+    return "not an event log index";
+  }
+  cursor += sizeof(kMagic);
+  std::uint8_t version = *cursor++;
+  if (version != 1 && version != kVersion) {
+    return "unsupported event log index version";
+  }
+
+  std::uint64_t event_count, client_count;
+  if (!readVarint(cursor, end, event_count) || event_count > UINT32_MAX ||
+      !readVarint(cursor, end, client_count) ||
+      client_count > static_cast<std::uint64_t>(end - cursor)) {
+    clear();
+    return "truncated header";
+  }
+  num_events = static_cast<std::uint32_t>(event_count);
+
+  for (std::uint64_t i = 0; i < client_count; ++i) {
+    std::string name;
+    if (!readBytes(cursor, end, name)) {
+      clear();
+      return "truncated client postings";
+    }
+    if (client_registry.find(name) != ClientRegistry::kNoClient) {
+      clear();
+      return "duplicate client";
+    }
+    if (!readPostings(cursor, end, num_events, postingsOfClient(name))) {
+      clear();
+      return "invalid client postings";
+    }
+  }
+
+  std::uint64_t table_count;
+  if (!readVarint(cursor, end, table_count) ||
+      table_count > static_cast<std::uint64_t>(end - cursor)) {
+    clear();
+    return "truncated table postings";
+  }
+  for (std::uint64_t i = 0; i < table_count; ++i) {
+    std::uint64_t table_id;
+    if (!readVarint(cursor, end, table_id) || table_id == 0 ||
+        table_id > INT32_MAX) {
+      clear();
+      return "invalid table id";
+    }
+    auto [it, inserted] =
+        table_postings.try_emplace(static_cast<int>(table_id));
+    if (!inserted || !readPostings(cursor, end, num_events, it->second)) {
+      clear();
+      return "invalid table postings";
+    }
+  }
+
+  std::uint64_t minute_count;
+  if (!readVarint(cursor, end, minute_count) ||
+      minute_count >= static_cast<std::uint64_t>(kMinutesPerDay)) {
+    clear();
+    return "invalid time index";
+  }
+  for (std::uint64_t minute = 1; minute <= minute_count; ++minute) {
+    std::uint64_t delta;
+    if (!readVarint(cursor, end, delta) ||
+        minute_starts[minute - 1] + delta > num_events) {
+      clear();
+      return "invalid time index";
+    }
+    minute_starts[minute] =
+        minute_starts[minute - 1] + static_cast<std::uint32_t>(delta);
+  }
+  last_minute = static_cast<int>(minute_count);
+
+  std::uint64_t late_count = 0;
+  if (version >= 2 &&
+      (!readVarint(cursor, end, late_count) || late_count > num_events)) {
+    clear();
+    return "invalid late events";
+  }
+  std::uint64_t late_position = 0;
+  for (std::uint64_t i = 0; i < late_count; ++i) {
+    std::uint64_t delta, minute;
+    if (!readVarint(cursor, end, delta) || (i > 0 && delta == 0) ||
+        (late_position += delta) >= num_events ||
+        !readVarint(cursor, end, minute) ||
+        minute >= static_cast<std::uint64_t>(kMinutesPerDay)) {
+      clear();
+      return "invalid late events";
+    }
+    late_events.push_back({static_cast<std::uint32_t>(late_position),
+                           static_cast<int>(minute)});
+  }
+
+  if (cursor != end) {
+    clear();
+    return "trailing bytes after index";
+  }
+  return std::nullopt;
+}
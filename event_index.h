@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "computer_club.h"
+
+// Secondary indexes over an output event log: positions of the events of
+// each client and each table, and the first position of every minute.
+// Lookups cost time proportional to the result, not to the log length.
+//
+// Times of a log almost never go back. The exception is the end of day
+// after an event accepted past closing time, e.g. "23:00 4 alice" followed
+// by "22:00 11 bob" with the club closing at 22:00. Such late events are
+// kept apart, with their minutes, and merged into time ranges.
+//
+// Persisted layout (version 2, LEB128 varints unless noted):
+//   "CCIX" magic, u8 version, event count
+//   client count, then per client: length + name, postings
+//   table count, then per table: table id, postings
+//   last indexed minute M, then the first positions of minutes 1..M as
+//   deltas from the previous minute
+//   late event count, then per late event: position delta, minute
+// where postings are a count followed by deltas between positions.
+// Version 1 is the same without late events and is still read.
+class EventLogIndex {
+public:
+  using Postings = std::vector<std::uint32_t>;
+  static constexpr char kMagic[4] = {'C', 'C', 'I', 'X'};
+  static constexpr std::uint8_t kVersion = 2;
+  static constexpr int kMinutesPerDay = 24 * 60;
+
+private:
+  ClientRegistry client_registry;
+  std::vector<Postings> client_postings;
+  std::unordered_map<int, Postings> table_postings;
+  // minute_starts[m] is the position of the first in-order event at
+  // minute >= m, filled up to last_minute, later minutes start at the end
+  // of the log
+  std::vector<std::uint32_t> minute_starts;
+  std::uint32_t num_events = 0;
+  int last_minute = 0;
+  // events earlier than last_minute when appended, in log order
+  struct LateEvent {
+    std::uint32_t position;
+    int minute;
+  };
+  std::vector<LateEvent> late_events;
+
+  Postings &postingsOfClient(const std::string &client_name);
+  std::uint32_t minuteStart(int minute) const;
+
+public:
+  EventLogIndex();
+
+  // events must come in log order
+  void append(const Event &event);
+  // indexes the events of log added since the previous call
+  void catchUp(const std::vector<Event> &event_log);
+  void clear();
+
+  std::size_t size() const;
+  const Postings &clientEvents(const std::string &client_name) const;
+  const Postings &tableEvents(int table_id) const;
+  // positions of the events from `from` to `to` inclusive, ascending
+  Postings timeRange(const Time &from, const Time &to) const;
+
+  std::string serialize() const;
+  // returns error description on malformed data
+  std::optional<std::string> deserialize(const std::string &data);
+};
@@ -1,91 +1,348 @@
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
-#include "computer_club.h"
+#include "binary_format.h"
+#include "club_async_io.h"
+#include "club_histogram.h"
+#include "club_incremental.h"
+#include "club_memory.h"
+#include "club_metrics.h"
+#include "club_rollup.h"
+#include "club_runner.h"
+#include "club_sharded.h"
+#include "club_timeline.h"
+#include "club_trace.h"
 
-int main(int argc, char *argv[]) {
-  if (argc != 2) {
-    std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
-    return 1;
+#ifdef CLUB_HAS_ASYNC_IO
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+int runRollup(const std::vector<std::string> &day_files, Tracer *tracer,
+              bool percentiles) {
+  RollupResult result = rollupDayFiles(day_files, 0, tracer);
+  for (const std::string &skipped : result.skipped_files) {
+    std::cerr << "Warning: no table statistics in " << skipped << std::endl;
+  }
+  std::cout << result.totals.days << '\n';
+  writeRollupReport(result.totals, std::cout);
+  std::cout.flush();
+  if (percentiles) {
+    writeDistributions(result.totals.distributions, std::cerr);
   }
+  return 0;
+}
 
-  std::string input_file_name = argv[1];
-  std::ifstream input_file(input_file_name);
+// the trace is written after the report, so a failure here keeps the report
+int writeTrace(const Tracer &tracer, const std::string &path, int exit_code) {
+  std::ofstream trace_file(path);
+  if (!trace_file.is_open()) {
+    std::cerr << "Error: Could not create file " << path << std::endl;
+    return 1;
+  }
+  std::optional<std::string> error = tracer.writeChromeTrace(trace_file);
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+  return exit_code;
+}
 
-  if (!input_file.is_open()) {
-    std::cerr << "Error: Could not open file " << input_file_name << std::endl;
+// CSV when the path ends in .csv, the binary form of club_timeline.h
+// otherwise; written after the report like the trace
+int writeOccupancy(const OccupancyCurve &curve, const std::string &path,
+                   int exit_code) {
+  bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+  std::ofstream file(path, csv ? std::ios::out
+                               : std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Error: Could not create file " << path << std::endl;
     return 1;
   }
+  if (csv) {
+    occupancy_format::writeCsv(curve, file);
+  } else {
+    std::string data = occupancy_format::encode(curve);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+  file.close();
+  if (!file) {
+    std::cerr << "Error: Could not write file " << path << std::endl;
+    return 1;
+  }
+  return exit_code;
+}
+
+int printUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--top-spenders N] [--metrics-shm /name]"
+               " [--trace out.json] [--mem-report] [--percentiles]"
+               " [--timeline out.csv|out.bin]"
+               " [--io auto|uring|threads|sync] <input_file>"
+            << std::endl;
+  std::cerr << "       " << program
+            << " [--top-spenders N] --incremental <sidecar> [--end-of-day]"
+               " <input_file>"
+            << std::endl;
+  std::cerr << "       " << program << " --sharded <output_dir> <input_file>"
+            << std::endl;
+  std::cerr << "       " << program
+            << " [--trace out.json] [--percentiles] --rollup <day_file>..."
+            << std::endl;
+  return 1;
+}
+
+// outputs of a full single club run besides the report and top spenders;
+// an incremental run resumes from the sidecar and cannot produce them
+bool hasFullRunOutputs(const RunOptions &options) {
+  return options.metrics != nullptr || options.trace != nullptr ||
+         options.memory_report != nullptr ||
+         options.distributions != nullptr || options.occupancy != nullptr;
+}
 
-  ComputerClub club;
-  std::optional<std::string> config_error_line =
-      club.loadConfiguration(input_file);
+// outputs that only exist for a single club run
+bool hasSingleClubOutputs(const RunOptions &options) {
+  return options.top_spenders != 0 || hasFullRunOutputs(options);
+}
 
-  if (config_error_line.has_value()) {
-    std::cout << config_error_line.value() << std::endl;
-    input_file.close();
-    return 0;
+// one report per club, <output_dir>/<club id>.txt
+int runSharded(const std::string &input_path, const std::string &output_dir) {
+  std::ifstream input_file(input_path);
+  if (!input_file.is_open()) {
+    std::cerr << "Error: Could not open file " << input_path << std::endl;
+    return 1;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(output_dir, error);
+  if (error) {
+    std::cerr << "Error: Could not create directory " << output_dir
+              << std::endl;
+    return 1;
+  }
+  ShardedRunResult result = runShardedInput(
+      input_file, 0,
+      [&output_dir](const std::string &club_id, const std::string &report) {
+        std::ofstream report_file(
+            (std::filesystem::path(output_dir) / (club_id + ".txt"))
+                .string());
+        report_file << report;
+        report_file.close();
+        return static_cast<bool>(report_file);
+      });
+  for (std::size_t line_number : result.invalid_lines) {
+    std::cerr << "Warning: no valid club id on line " << line_number
+              << ", skipped" << std::endl;
   }
+  for (const std::string &club_id : result.failed_clubs) {
+    std::cerr << "Error: Could not write file "
+              << (std::filesystem::path(output_dir) / (club_id + ".txt"))
+                     .string()
+              << std::endl;
+  }
+  return result.failed_clubs.empty() ? 0 : 1;
+}
 
-  std::cout << club.getOpenTime().toString() << std::endl;
+#ifdef CLUB_HAS_ASYNC_IO
+// the report through read-ahead and write-behind buffers; the runners see
+// ordinary streams, so the output is the same as with --io sync
+int runAsync(int input_fd, const std::string &input_path, bool is_binary,
+             AsyncIoBackend &backend, const RunOptions &options) {
+  AsyncReadBuffer input_buffer(input_fd, backend);
+  AsyncWriteBuffer output_buffer(STDOUT_FILENO, backend);
+  std::istream input(&input_buffer);
+  std::ostream output(&output_buffer);
+  int exit_code = is_binary
+                      ? runBinaryInput(input, output, std::cerr, options)
+                      : runTextInput(input, output, options);
+  std::optional<std::string> error = output_buffer.finish();
+  if (error.has_value()) {
+    std::cerr << "Error: Could not write output: " << error.value()
+              << std::endl;
+    return 1;
+  }
+  error = input_buffer.error();
+  if (error.has_value()) {
+    std::cerr << "Error: Could not read file " << input_path << ": "
+              << error.value() << std::endl;
+    return 1;
+  }
+  return exit_code;
+}
+#endif
 
-  std::string event_line_str;
-  Time last_event_time(0, 0);
-  bool first_event = true;
+} // namespace
 
-  while (std::getline(input_file, event_line_str)) {
-    if (event_line_str.empty()) {
-      continue;
-    }
-    std::string time_str_from_event;
-    std::istringstream iss_event_peek(event_line_str);
-    iss_event_peek >> time_str_from_event;
-
-    Time current_event_time;
-    try {
-      current_event_time = Time::parse(time_str_from_event);
-    } catch (const std::runtime_error &) {
-      // Ошибка формата времени в строке события
-      std::cout << event_line_str << std::endl;
-      input_file.close();
-      return 0;
+int main(int argc, char *argv[]) {
+  RunOptions options;
+  SharedMetricsRegion metrics_region;
+  std::optional<MetricsWriter> metrics_writer;
+  std::optional<Tracer> tracer;
+  std::string trace_path;
+  MemoryReport memory_report;
+  ClubDistributions distributions;
+  OccupancyCurve occupancy;
+  std::string occupancy_path;
+  std::optional<std::string> sidecar_path;
+  std::optional<std::string> sharded_dir;
+  bool end_of_day = false;
+  std::optional<AsyncIoMode> io_mode;
+#ifdef CLUB_HAS_ASYNC_IO
+  io_mode = AsyncIoMode::AUTO;
+#endif
+  int arg = 1;
+  for (; arg + 1 < argc; ++arg) {
+    std::string option = argv[arg];
+    if (option == "--top-spenders" && arg + 2 < argc) {
+      int count = utils::parsePositiveInteger(argv[++arg]);
+      if (count <= 0) {
+        std::cerr << "Error: invalid client count " << argv[arg] << std::endl;
+        return 1;
+      }
+      options.top_spenders = static_cast<std::size_t>(count);
+    } else if (option == "--metrics-shm" && arg + 2 < argc) {
+      std::optional<std::string> error = metrics_region.create(argv[++arg]);
+      if (error.has_value()) {
+        std::cerr << "Error: " << error.value() << std::endl;
+        return 1;
+      }
+      metrics_writer.emplace(*metrics_region.block());
+      options.metrics = &metrics_writer.value();
+    } else if (option == "--trace" && arg + 2 < argc) {
+      trace_path = argv[++arg];
+      tracer.emplace();
+      options.trace = &tracer.value();
+    } else if (option == "--mem-report") {
+      if (!isMemoryAccountingSupported()) {
+        std::cerr << "Error: memory accounting is not supported on this "
+                     "platform"
+                  << std::endl;
+        return 1;
+      }
+      // before the engine exists, so all of its allocations are counted
+      enableMemoryAccounting();
+      options.memory_report = &memory_report;
+    } else if (option == "--percentiles") {
+      options.distributions = &distributions;
+    } else if (option == "--timeline" && arg + 2 < argc) {
+      occupancy_path = argv[++arg];
+      options.occupancy = &occupancy;
+    } else if (option == "--incremental" && arg + 2 < argc) {
+      sidecar_path = argv[++arg];
+    } else if (option == "--sharded" && arg + 2 < argc) {
+      sharded_dir = argv[++arg];
+    } else if (option == "--io" && arg + 2 < argc) {
+      std::string io = argv[++arg];
+      if (io == "sync") {
+        io_mode.reset();
+      } else if (io == "auto" || io == "uring" || io == "threads") {
+#ifdef CLUB_HAS_ASYNC_IO
+        io_mode = io == "auto"    ? AsyncIoMode::AUTO
+                  : io == "uring" ? AsyncIoMode::URING
+                                  : AsyncIoMode::THREAD;
+#else
+        std::cerr << "Error: asynchronous I/O is not supported on this "
+                     "platform"
+                  << std::endl;
+        return 1;
+#endif
+      } else {
+        std::cerr << "Error: invalid I/O mode " << io << std::endl;
+        return 1;
+      }
+    } else if (option == "--end-of-day") {
+      end_of_day = true;
+    } else if (option == "--rollup") {
+      // a rollup writes summed table totals, a trace and percentiles only
+      if (options.top_spenders != 0 || options.metrics != nullptr ||
+          options.memory_report != nullptr || options.occupancy != nullptr ||
+          sidecar_path.has_value() || sharded_dir.has_value() || end_of_day) {
+        return printUsage(argv[0]);
+      }
+      int exit_code = runRollup(
+          std::vector<std::string>(argv + arg + 1, argv + argc), options.trace,
+          options.distributions != nullptr);
+      return tracer.has_value() ? writeTrace(*tracer, trace_path, exit_code)
+                                : exit_code;
+    } else {
+      break;
     }
+  }
+  // the sidecar keeps no distributions or timeline, so they are only known
+  // for a full run; sharded runs write plain reports only
+  if (arg + 1 != argc || (end_of_day && !sidecar_path.has_value()) ||
+      (sidecar_path.has_value() && hasFullRunOutputs(options)) ||
+      (sharded_dir.has_value() &&
+       (sidecar_path.has_value() || hasSingleClubOutputs(options)))) {
+    return printUsage(argv[0]);
+  }
 
-    if (!first_event && current_event_time < last_event_time) {
-      // Нарушение последовательности времени событий
-      std::cout << event_line_str << std::endl;
-      input_file.close();
-      return 0;
+  std::string input_file_name = argv[arg];
+  if (sharded_dir.has_value()) {
+    return runSharded(input_file_name, sharded_dir.value());
+  }
+  if (sidecar_path.has_value()) {
+    int exit_code = incremental::runIncrementalFile(
+        input_file_name, sidecar_path.value(), std::cout, std::cerr,
+        end_of_day, options);
+    std::cout.flush();
+    return exit_code;
+  }
+  bool is_binary = binary_format::isBinaryEventFile(input_file_name);
+  int exit_code;
+#ifdef CLUB_HAS_ASYNC_IO
+  if (io_mode.has_value()) {
+    std::string error;
+    std::unique_ptr<AsyncIoBackend> backend =
+        makeAsyncIoBackend(*io_mode, &error);
+    if (backend == nullptr) {
+      std::cerr << "Error: " << error << std::endl;
+      return 1;
     }
+    int input_fd = ::open(input_file_name.c_str(), O_RDONLY | O_CLOEXEC);
+    if (input_fd < 0) {
+      std::cerr << "Error: Could not open file " << input_file_name
+                << std::endl;
+      return 1;
+    }
+    exit_code = runAsync(input_fd, input_file_name, is_binary, *backend,
+                         options);
+    ::close(input_fd);
+  } else
+#endif
+  {
+    std::ios::openmode mode =
+        is_binary ? std::ios::in | std::ios::binary : std::ios::in;
+    std::ifstream input_file(input_file_name, mode);
 
-    std::optional<std::string> event_format_error =
-        club.processEventLine(event_line_str);
-
-    if (event_format_error.has_value()) {
-      std::cout << event_format_error.value() << std::endl;
-      input_file.close();
-      return 0;
+    if (!input_file.is_open()) {
+      std::cerr << "Error: Could not open file " << input_file_name
+                << std::endl;
+      return 1;
     }
 
-    last_event_time = current_event_time;
-    first_event = false;
+    exit_code =
+        is_binary ? runBinaryInput(input_file, std::cout, std::cerr, options)
+                  : runTextInput(input_file, std::cout, options);
+    std::cout.flush();
   }
-
-  club.processEndOfDay();
-
-  for (const auto &logged_event : club.getEventLog()) {
-    std::cout << logged_event.toString() << std::endl;
+  if (options.memory_report != nullptr) {
+    writeMemoryReport(memory_report, std::cerr);
   }
-
-  std::cout << club.getCloseTime().toString() << std::endl;
-
-  for (const auto &table_stat_line : club.getTableStatistics()) {
-    std::cout << table_stat_line << std::endl;
+  if (options.distributions != nullptr) {
+    writeDistributions(distributions, std::cerr);
   }
-
-  input_file.close();
-  return 0;
-}
\ No newline at end of file
+  if (options.occupancy != nullptr) {
+    exit_code = writeOccupancy(occupancy, occupancy_path, exit_code);
+  }
+  if (tracer.has_value()) {
+    return writeTrace(*tracer, trace_path, exit_code);
+  }
+  return exit_code;
+}
@@ -0,0 +1,132 @@
+#include "binary_format.h"
+#include "club_runner.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using test_helpers::runText;
+using test_helpers::writeTempFile;
+
+const char *kSampleInput = "3\n"
+                           "09:00 19:00\n"
+                           "10\n"
+                           "08:48 1 client1\n"
+                           "09:41 1 client1\n"
+                           "09:48 1 client2\n"
+                           "09:52 3 client1\n"
+                           "09:54 2 client1 1\n"
+                           "10:25 2 client2 2\n"
+                           "10:58 1 client3\n"
+                           "10:59 2 client3 3\n"
+                           "11:30 1 client4\n"
+                           "11:35 2 client4 2\n"
+                           "11:45 3 client4\n"
+                           "12:33 4 client1\n"
+                           "12:43 4 client2\n"
+                           "15:52 4 client4\n";
+
+std::string toBinary(const std::string &text) {
+  std::istringstream in(text);
+  std::ostringstream out;
+  EXPECT_FALSE(binary_format::convertTextToBinary(in, out).has_value());
+  return out.str();
+}
+
+std::string runBinary(const std::string &data) {
+  std::istringstream in(data);
+  std::ostringstream out, errors;
+  EXPECT_EQ(runBinaryInput(in, out, errors), 0);
+  EXPECT_TRUE(errors.str().empty());
+  return out.str();
+}
+
+} // namespace
+
+TEST(BinaryFormatTest, SameOutputAsText) {
+  std::string binary = toBinary(kSampleInput);
+  ASSERT_EQ(binary.compare(0, 4, "CCEB"), 0);
+  ASSERT_EQ(runBinary(binary), runText(kSampleInput));
+}
+
+TEST(BinaryFormatTest, RejectedLineIsKeptVerbatim) {
+  std::string bad_name = "1\n09:00 19:00\n10\n09:10 1 client1\n09:20 1 Bad\n"
+                         "09:30 1 client2\n";
+  ASSERT_EQ(runBinary(toBinary(bad_name)), runText(bad_name));
+
+  std::string backwards = "1\n09:00 19:00\n10\n09:10 1 client1\n"
+                          "09:05 1 client2\n";
+  ASSERT_EQ(runBinary(toBinary(backwards)), runText(backwards));
+  ASSERT_EQ(runBinary(toBinary(backwards)), "09:00\n09:05 1 client2\n");
+}
+
+TEST(BinaryFormatTest, RoundTripToText) {
+  std::istringstream binary_in(toBinary(kSampleInput));
+  std::ostringstream text_out;
+  ASSERT_FALSE(
+      binary_format::convertBinaryToText(binary_in, text_out).has_value());
+  ASSERT_EQ(text_out.str(), kSampleInput);
+}
+
+TEST(BinaryFormatTest, InvalidConfigurationIsNotConverted) {
+  std::istringstream in("0\n09:00 19:00\n10\n");
+  std::ostringstream out;
+  ASSERT_TRUE(binary_format::convertTextToBinary(in, out).has_value());
+}
+
+TEST(BinaryFormatTest, CorruptedFileIsReported) {
+  std::string binary = toBinary(kSampleInput);
+
+  binary_format::Reader reader;
+  ASSERT_TRUE(reader.open("CCEB").has_value());
+  ASSERT_TRUE(reader.open(std::string("XXXX") + binary.substr(4)).has_value());
+
+  std::istringstream in(binary.substr(0, binary.size() - 3));
+  std::ostringstream out, errors;
+  ASSERT_EQ(runBinaryInput(in, out, errors), 1);
+  ASSERT_FALSE(errors.str().empty());
+}
+
+TEST(BinaryFormatTest, TextStartingWithMagicIsText) {
+  std::string text = "CCEB 3\n09:00 19:00\n10\n";
+  std::string binary = toBinary(kSampleInput);
+  EXPECT_FALSE(binary_format::isBinaryEventFile(
+      writeTempFile("magic_text.txt", text)));
+  // the header must validate, not only the magic and version
+  EXPECT_FALSE(binary_format::isBinaryEventFile(
+      writeTempFile("magic_bad_header.bin", binary.substr(0, 5) + "\x7f")));
+  EXPECT_TRUE(binary_format::isBinaryEventFile(
+      writeTempFile("magic_binary.bin", binary)));
+  // the text path echoes the bad configuration line, like any text input
+  EXPECT_EQ(runText(text), "CCEB 3\n");
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(BinaryFormatTest, PipesAreNotSniffed) {
+  // opening the FIFO would block without a writer, and reading it would
+  // take the bytes meant for the run
+  std::string path = ::testing::TempDir() + "sniff_fifo";
+  ::unlink(path.c_str());
+  ASSERT_EQ(::mkfifo(path.c_str(), 0600), 0);
+  EXPECT_FALSE(binary_format::isBinaryEventFile(path));
+  ::unlink(path.c_str());
+}
+#endif
+
+TEST(BinaryFormatTest, SeveralTimesSmaller) {
+  workload::Spec spec;
+  spec.num_events = 20000;
+  std::string text = workload::generate(spec);
+  std::string binary = toBinary(text);
+  ASSERT_LT(binary.size() * 3, text.size());
+  ASSERT_EQ(runBinary(binary), runText(text));
+}
@@ -0,0 +1,134 @@
+#include "club_runner.h"
+#include "computer_club.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Club> void runDay(Club &club, const std::string &text) {
+  std::istringstream input(text);
+  ASSERT_FALSE(club.loadConfiguration(input).has_value());
+  std::string line;
+  while (std::getline(input, line)) {
+    ASSERT_FALSE(club.processEventLine(line).has_value());
+  }
+  club.processEndOfDay();
+}
+
+// every billed session belongs to exactly one table and one client
+template <typename Club> void expectLedgerMatchesTables(const std::string &t) {
+  Club club;
+  runDay(club, t);
+
+  TableStatsSummary tables = club.getTableTotals();
+  std::int64_t table_minutes = 0, table_revenue = 0;
+  for (int i = 0; i < tables.numTables(); ++i) {
+    table_minutes += tables.minutes_used[i];
+    table_revenue += tables.revenue[i];
+  }
+  std::int64_t client_minutes = 0, client_revenue = 0;
+  std::vector<ClientBill> all = club.getTopSpenders(1000000);
+  for (const ClientBill &bill : all) {
+    client_minutes += bill.minutes;
+    client_revenue += bill.revenue;
+    EXPECT_EQ(bill.revenue, std::int64_t{bill.billed_hours} * 10);
+  }
+  EXPECT_EQ(client_minutes, table_minutes);
+  EXPECT_EQ(client_revenue, table_revenue);
+  for (std::size_t i = 1; i < all.size(); ++i) {
+    EXPECT_GE(all[i - 1].revenue, all[i].revenue);
+  }
+}
+
+} // namespace
+
+TEST(ClientLedgerTest, SessionsOnSeveralTablesAddUp) {
+  ComputerClub club;
+  runDay(club, "2\n09:00 19:00\n10\n"
+               "09:00 1 alice\n"
+               "09:00 2 alice 1\n"
+               "09:30 2 alice 2\n" // 30 min on table 1
+               "09:31 1 bob\n"
+               "09:32 2 bob 1\n"
+               "09:33 1 carol\n"
+               "09:34 3 carol\n"
+               "10:00 1 dave\n"
+               "10:01 3 dave\n"
+               "10:15 4 bob\n"     // carol is seated at 1 by event 12
+               "11:45 4 alice\n"); // 2h15 on table 2, dave seated at 2
+
+  ClientBill alice = club.getClientBill("alice");
+  EXPECT_EQ(alice.client_name, "alice");
+  EXPECT_EQ(alice.sessions, 2u);
+  EXPECT_EQ(alice.minutes, 30 + 135);
+  EXPECT_EQ(alice.billed_hours, 1u + 3u);
+  EXPECT_EQ(alice.revenue, 40);
+
+  ClientBill carol = club.getClientBill("carol");
+  EXPECT_EQ(carol.sessions, 1u);
+  EXPECT_EQ(carol.minutes, 19 * 60 - (10 * 60 + 15));
+  EXPECT_EQ(carol.revenue, 90);
+
+  ClientBill dave = club.getClientBill("dave");
+  EXPECT_EQ(dave.sessions, 1u);
+  EXPECT_EQ(dave.revenue, 80);
+
+  ClientBill nobody = club.getClientBill("nobody");
+  EXPECT_EQ(nobody.sessions, 0u);
+  EXPECT_EQ(nobody.revenue, 0);
+
+  std::vector<ClientBill> top = club.getTopSpenders(2);
+  ASSERT_EQ(top.size(), 2u);
+  EXPECT_EQ(top[0].client_name, "carol");
+  EXPECT_EQ(top[1].client_name, "dave");
+  EXPECT_EQ(club.getTopSpenders(100).size(), 4u);
+  EXPECT_TRUE(club.getTopSpenders(0).empty());
+}
+
+TEST(ClientLedgerTest, TiesAreOrderedByName) {
+  ComputerClub club;
+  runDay(club, "2\n09:00 19:00\n10\n"
+               "09:00 1 zed\n"
+               "09:00 1 amy\n"
+               "09:00 2 zed 1\n"
+               "09:00 2 amy 2\n"
+               "09:30 4 zed\n"
+               "09:30 4 amy\n");
+  std::vector<ClientBill> top = club.getTopSpenders(2);
+  ASSERT_EQ(top.size(), 2u);
+  EXPECT_EQ(top[0].client_name, "amy");
+  EXPECT_EQ(top[1].client_name, "zed");
+}
+
+TEST(ClientLedgerTest, LedgerMatchesTableTotalsOnWorkloads) {
+  for (int tables : {3, 64, 200}) {
+    workload::Spec spec;
+    spec.num_tables = tables;
+    spec.num_clients = tables * 3;
+    spec.num_events = 20000;
+    std::string text = workload::generate(spec);
+    expectLedgerMatchesTables<ComputerClub>(text);
+    expectLedgerMatchesTables<SparseComputerClub>(text);
+    if (tables <= 64) {
+      expectLedgerMatchesTables<SmallComputerClub>(text);
+    }
+  }
+}
+
+TEST(ClientLedgerTest, ReportListsTopSpendersAfterStatistics) {
+  std::string text = "1\n09:00 19:00\n10\n"
+                     "09:00 1 alice\n"
+                     "09:00 2 alice 1\n"
+                     "10:30 4 alice\n";
+  std::istringstream plain_in(text), top_in(text);
+  std::ostringstream plain, top;
+  runTextInput(plain_in, plain);
+  RunOptions options;
+  options.top_spenders = 5;
+  runTextInput(top_in, top, options);
+  EXPECT_EQ(top.str(), plain.str() + "alice 20 01:30 2 1\n");
+}
@@ -0,0 +1,183 @@
+#include "club_async_io.h"
+#include "club_runner.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#ifdef CLUB_HAS_ASYNC_IO
+
+#include <cstdio>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+using test_helpers::runText;
+
+std::vector<AsyncIoMode> availableModes() {
+  std::vector<AsyncIoMode> modes = {AsyncIoMode::THREAD};
+  if (isIoUringSupported()) {
+    modes.push_back(AsyncIoMode::URING);
+  }
+  return modes;
+}
+
+std::string generated() {
+  workload::Spec spec;
+  spec.num_tables = 20;
+  spec.num_clients = 200;
+  spec.num_events = 5000;
+  spec.seed = 3;
+  return workload::generate(spec);
+}
+
+std::string readAll(int fd) {
+  std::string data;
+  char chunk[4096];
+  ssize_t length;
+  while ((length = ::read(fd, chunk, sizeof(chunk))) > 0) {
+    data.append(chunk, static_cast<std::size_t>(length));
+  }
+  return data;
+}
+
+} // namespace
+
+TEST(ClubAsyncIoTest, FileRoundTripMatchesSyncRun) {
+  std::string text = generated();
+  std::string expected = runText(text);
+  for (AsyncIoMode mode : availableModes()) {
+    std::unique_ptr<AsyncIoBackend> backend = makeAsyncIoBackend(mode);
+    ASSERT_NE(backend, nullptr);
+    SCOPED_TRACE(backend->name());
+    // small odd buffers, so reads and writes cross many buffer boundaries
+    for (std::size_t buffer_size : {std::size_t{1000}, std::size_t{1} << 20}) {
+      std::FILE *input_file = std::tmpfile();
+      std::FILE *output_file = std::tmpfile();
+      ASSERT_NE(input_file, nullptr);
+      ASSERT_NE(output_file, nullptr);
+      ASSERT_EQ(std::fwrite(text.data(), 1, text.size(), input_file),
+                text.size());
+      std::fflush(input_file);
+      {
+        AsyncReadBuffer input_buffer(fileno(input_file), *backend,
+                                     buffer_size, 3);
+        AsyncWriteBuffer output_buffer(fileno(output_file), *backend,
+                                       buffer_size);
+        std::istream input(&input_buffer);
+        std::ostream output(&output_buffer);
+        runTextInput(input, output);
+        EXPECT_EQ(output_buffer.finish(), std::nullopt);
+        EXPECT_EQ(input_buffer.error(), std::nullopt);
+      }
+      ASSERT_EQ(::lseek(fileno(output_file), 0, SEEK_SET), 0);
+      EXPECT_EQ(readAll(fileno(output_file)), expected);
+      std::fclose(input_file);
+      std::fclose(output_file);
+    }
+  }
+}
+
+TEST(ClubAsyncIoTest, PipesAreReadAndWrittenInOrder) {
+  std::string text = generated();
+  for (AsyncIoMode mode : availableModes()) {
+    std::unique_ptr<AsyncIoBackend> backend = makeAsyncIoBackend(mode);
+    ASSERT_NE(backend, nullptr);
+    SCOPED_TRACE(backend->name());
+    int input_pipe[2];
+    int output_pipe[2];
+    ASSERT_EQ(pipe(input_pipe), 0);
+    ASSERT_EQ(pipe(output_pipe), 0);
+    // the text is larger than a pipe buffer, both ends need their own thread
+    std::thread writer([&] {
+      ASSERT_EQ(::write(input_pipe[1], text.data(), text.size()),
+                static_cast<ssize_t>(text.size()));
+      ::close(input_pipe[1]);
+    });
+    std::string copied;
+    std::thread reader([&] { copied = readAll(output_pipe[0]); });
+    {
+      AsyncReadBuffer input_buffer(input_pipe[0], *backend, 4096);
+      AsyncWriteBuffer output_buffer(output_pipe[1], *backend, 4096);
+      std::istream input(&input_buffer);
+      std::ostream output(&output_buffer);
+      output << input.rdbuf();
+      EXPECT_EQ(output_buffer.finish(), std::nullopt);
+    }
+    ::close(output_pipe[1]);
+    writer.join();
+    reader.join();
+    ::close(input_pipe[0]);
+    ::close(output_pipe[0]);
+    EXPECT_EQ(copied, text);
+  }
+}
+
+TEST(ClubAsyncIoTest, PipeDataIsHandedOverBeforeBufferFills) {
+  for (AsyncIoMode mode : availableModes()) {
+    std::unique_ptr<AsyncIoBackend> backend = makeAsyncIoBackend(mode);
+    ASSERT_NE(backend, nullptr);
+    SCOPED_TRACE(backend->name());
+    int input_pipe[2];
+    ASSERT_EQ(pipe(input_pipe), 0);
+    ASSERT_EQ(::write(input_pipe[1], "09:00\n", 6), 6);
+    {
+      // the writer stays open, a read waiting for a full buffer would hang
+      AsyncReadBuffer input_buffer(input_pipe[0], *backend, 4096);
+      std::istream input(&input_buffer);
+      std::string line;
+      ASSERT_TRUE(std::getline(input, line));
+      EXPECT_EQ(line, "09:00");
+      ASSERT_EQ(::write(input_pipe[1], "19:00\n", 6), 6);
+      ASSERT_TRUE(std::getline(input, line));
+      EXPECT_EQ(line, "19:00");
+      ::close(input_pipe[1]);
+      EXPECT_FALSE(std::getline(input, line));
+      EXPECT_EQ(input_buffer.error(), std::nullopt);
+    }
+    ::close(input_pipe[0]);
+  }
+}
+
+TEST(ClubAsyncIoTest, ErrorsAreReported) {
+  for (AsyncIoMode mode : availableModes()) {
+    std::unique_ptr<AsyncIoBackend> backend = makeAsyncIoBackend(mode);
+    ASSERT_NE(backend, nullptr);
+    SCOPED_TRACE(backend->name());
+    int write_only = ::open("/dev/null", O_WRONLY);
+    int read_only = ::open("/dev/null", O_RDONLY);
+    ASSERT_GE(write_only, 0);
+    ASSERT_GE(read_only, 0);
+    {
+      AsyncReadBuffer input_buffer(write_only, *backend);
+      std::istream input(&input_buffer);
+      EXPECT_EQ(input.get(), std::char_traits<char>::eof());
+      EXPECT_NE(input_buffer.error(), std::nullopt);
+
+      AsyncWriteBuffer output_buffer(read_only, *backend);
+      std::ostream output(&output_buffer);
+      output << "12:00\n";
+      EXPECT_NE(output_buffer.finish(), std::nullopt);
+    }
+    ::close(write_only);
+    ::close(read_only);
+  }
+}
+
+TEST(ClubAsyncIoTest, UringModeFailsOnlyWithoutKernelSupport) {
+  std::string error;
+  std::unique_ptr<AsyncIoBackend> backend =
+      makeAsyncIoBackend(AsyncIoMode::URING, &error);
+  EXPECT_EQ(backend != nullptr, isIoUringSupported());
+  EXPECT_EQ(error.empty(), isIoUringSupported());
+  EXPECT_NE(makeAsyncIoBackend(AsyncIoMode::AUTO), nullptr);
+}
+
+#endif
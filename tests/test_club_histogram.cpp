@@ -0,0 +1,129 @@
+#include "club_histogram.h"
+#include "club_rollup.h"
+#include "club_runner.h"
+#include "computer_club.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(LogLinearHistogramTest, BucketsCoverValuesWithoutGaps) {
+  std::size_t previous_index = 0;
+  for (std::uint32_t value = 0;
+       value <= LogLinearHistogram::kMaxTrackedValue; ++value) {
+    std::size_t index = LogLinearHistogram::bucketIndex(value);
+    ASSERT_LT(index, LogLinearHistogram::kBucketCount);
+    ASSERT_TRUE(index == previous_index || index == previous_index + 1)
+        << value;
+    ASSERT_LE(value, LogLinearHistogram::bucketUpperBound(index));
+    previous_index = index;
+  }
+  EXPECT_EQ(previous_index + 1, LogLinearHistogram::kBucketCount);
+  EXPECT_EQ(LogLinearHistogram::bucketIndex(1000000), previous_index);
+  // exact below the linear limit
+  EXPECT_EQ(LogLinearHistogram::bucketUpperBound(7), 7u);
+}
+
+TEST(LogLinearHistogramTest, QuantilesWithinRelativeError) {
+  std::mt19937 rng(5);
+  std::exponential_distribution<double> minutes(1.0 / 90);
+  LogLinearHistogram histogram;
+  std::vector<std::uint32_t> values;
+  for (int i = 0; i < 100000; ++i) {
+    auto value = static_cast<std::uint32_t>(minutes(rng));
+    values.push_back(value);
+    histogram.record(value);
+  }
+  std::sort(values.begin(), values.end());
+  for (double quantile : {0.5, 0.95, 0.99}) {
+    std::uint32_t exact = values[static_cast<std::size_t>(
+        quantile * static_cast<double>(values.size())) - 1];
+    std::uint32_t estimate = histogram.valueAtQuantile(quantile);
+    EXPECT_GE(estimate, exact) << quantile;
+    EXPECT_LE(estimate - exact,
+              exact / LogLinearHistogram::kSubBuckets + 1) << quantile;
+  }
+  EXPECT_EQ(histogram.count(), values.size());
+  EXPECT_EQ(histogram.min(), values.front());
+  EXPECT_EQ(histogram.max(), values.back());
+  EXPECT_EQ(histogram.valueAtQuantile(1.0), values.back());
+  EXPECT_EQ(LogLinearHistogram().valueAtQuantile(0.5), 0u);
+}
+
+TEST(LogLinearHistogramTest, MergeEqualsRecordingEverything) {
+  LogLinearHistogram all, first, second;
+  for (std::uint32_t value = 0; value < 3000; value += 7) {
+    all.record(value);
+    (value % 2 == 0 ? first : second).record(value);
+  }
+  LogLinearHistogram merged;
+  merged.merge(first);
+  merged.merge(LogLinearHistogram());
+  merged.merge(second);
+  EXPECT_EQ(merged, all);
+}
+
+TEST(ClubDistributionsTest, EngineRecordsSessionsAndQueueWaits) {
+  std::istringstream in("1\n09:00 19:00\n10\n"
+                        "09:00 1 alice\n"
+                        "09:00 1 bob\n"
+                        "09:05 2 alice 1\n"
+                        "09:10 3 bob\n"
+                        "10:00 4 alice\n");
+  ComputerClub club;
+  ASSERT_FALSE(club.loadConfiguration(in).has_value());
+  std::string line;
+  while (std::getline(in, line)) {
+    ASSERT_FALSE(club.processEventLine(line).has_value());
+  }
+  const ClubDistributions &distributions = club.getDistributions();
+  // bob waited from 09:10 to 10:00 and still sits, so only alice is counted
+  EXPECT_EQ(distributions.session_minutes.count(), 1u);
+  EXPECT_EQ(distributions.session_minutes.max(), 55u);
+  EXPECT_EQ(distributions.queue_wait_minutes.count(), 1u);
+  EXPECT_EQ(distributions.queue_wait_minutes.max(), 50u);
+
+  club.processEndOfDay();
+  EXPECT_EQ(distributions.session_minutes.count(), 2u);
+  EXPECT_EQ(distributions.session_minutes.max(), 540u);
+  EXPECT_EQ(distributions.session_minutes.sum(), 595u);
+}
+
+TEST(ClubDistributionsTest, DaysMergeThroughTableTotals) {
+  workload::Spec spec;
+  spec.num_tables = 3;
+  spec.num_clients = 40;
+  spec.num_events = 5000;
+  std::string first_day = workload::generate(spec);
+  spec.seed = 43;
+  std::string second_day = workload::generate(spec);
+
+  ClubDistributions expected;
+  for (const std::string &day : {first_day, second_day}) {
+    ClubDistributions distributions;
+    RunOptions options;
+    options.distributions = &distributions;
+    std::istringstream in(day);
+    std::ostringstream out;
+    runTextInput(in, out, options);
+    EXPECT_GT(distributions.queue_wait_minutes.count(), 0u);
+    expected.merge(distributions);
+  }
+
+  std::istringstream first_in(first_day), second_in(second_day);
+  std::optional<TableStatsSummary> total = summarizeTextInput(first_in);
+  std::optional<TableStatsSummary> second = summarizeTextInput(second_in);
+  ASSERT_TRUE(total.has_value() && second.has_value());
+  total->merge(second.value());
+  EXPECT_EQ(total->distributions, expected);
+
+  std::ostringstream text;
+  writeDistributions(expected, text);
+  EXPECT_EQ(text.str().rfind("session_minutes count ", 0), 0u);
+  EXPECT_NE(text.str().find("\nqueue_wait_minutes count "), std::string::npos);
+}
@@ -0,0 +1,131 @@
+#include "club_incremental.h"
+#include "club_runner.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test_helpers::runText;
+
+// one run over the first `length` bytes of text; the sidecar goes
+// through its persisted form between runs
+std::string runPrefix(const std::string &text, std::size_t length,
+                      std::string &sidecar_image, bool end_of_day,
+                      incremental::AppendedRun *run = nullptr) {
+  incremental::Sidecar sidecar;
+  if (!sidecar_image.empty()) {
+    EXPECT_FALSE(incremental::decode(sidecar_image, sidecar).has_value());
+  }
+  std::istringstream in(text.substr(0, length));
+  std::ostringstream out;
+  incremental::AppendedRun result =
+      incremental::runAppended(in, sidecar, out, end_of_day);
+  if (run != nullptr) {
+    *run = result;
+  }
+  sidecar_image = incremental::encode(sidecar);
+  return out.str();
+}
+
+} // namespace
+
+TEST(ClubIncrementalTest, RunsOverGrowingInputAddUpToTheReport) {
+  workload::Spec spec;
+  spec.num_tables = 6;
+  spec.num_events = 3000;
+  std::string text = workload::generate(spec);
+
+  // cuts fall anywhere, mostly inside lines and inside the configuration
+  std::mt19937 rng(7);
+  std::vector<std::size_t> cuts = {0, 3, 9, 20};
+  while (cuts.back() < text.size()) {
+    cuts.push_back(std::min(text.size(), cuts.back() + rng() % 4000));
+  }
+
+  std::string sidecar, combined;
+  for (std::size_t cut : cuts) {
+    combined += runPrefix(text, cut, sidecar, false);
+  }
+  combined += runPrefix(text, text.size(), sidecar, true);
+  EXPECT_EQ(combined, runText(text));
+
+  // the day is closed, later runs print nothing
+  EXPECT_EQ(runPrefix(text + "22:00 1 late\n", text.size() + 13, sidecar,
+                      false),
+            "");
+}
+
+TEST(ClubIncrementalTest, ReadsOnlyAppendedBytes) {
+  std::string text = "3\n09:00 19:00\n10\n09:41 1 client1\n09:48 1 client2\n";
+  std::string sidecar;
+  EXPECT_EQ(runPrefix(text, text.size(), sidecar, false),
+            "09:00\n09:41 1 client1\n09:48 1 client2\n");
+
+  incremental::AppendedRun run;
+  text += "09:52 3 client1\n09:54 2 client1";
+  EXPECT_EQ(runPrefix(text, text.size(), sidecar, false, &run),
+            "09:52 3 client1\n09:52 13 ICanWaitNoLonger!\n");
+  EXPECT_EQ(run.bytes_read, 31u);
+  EXPECT_FALSE(run.restarted);
+
+  // the line finished by the writer is picked up on the next run
+  text += " 1\n";
+  EXPECT_EQ(runPrefix(text, text.size(), sidecar, false, &run),
+            "09:54 2 client1 1\n");
+  EXPECT_EQ(run.bytes_read, 18u);
+}
+
+TEST(ClubIncrementalTest, FinalRunTakesTheLastLineWithoutNewline) {
+  std::string text = "3\n09:00 19:00\n10\n09:41 1 client1\n09:54 2 client1 1";
+  std::string sidecar;
+  std::string combined = runPrefix(text, text.size(), sidecar, false);
+  combined += runPrefix(text, text.size(), sidecar, true);
+  EXPECT_EQ(combined, runText(text));
+}
+
+TEST(ClubIncrementalTest, ChangedPrefixRestartsTheDay) {
+  std::string text = "3\n09:00 19:00\n10\n09:41 1 client1\n09:48 1 client2\n";
+  std::string sidecar;
+  runPrefix(text, text.size(), sidecar, false);
+
+  std::string rewritten =
+      "3\n09:00 19:00\n10\n09:41 1 client7\n09:48 1 client2\n10:00 1 x\n";
+  incremental::AppendedRun run;
+  std::string output =
+      runPrefix(rewritten, rewritten.size(), sidecar, true, &run);
+  EXPECT_TRUE(run.restarted);
+  EXPECT_EQ(output, runText(rewritten));
+
+  // truncation is caught too
+  runPrefix(text, 20, sidecar, false, &run);
+  EXPECT_TRUE(run.restarted);
+}
+
+TEST(ClubIncrementalTest, RejectedLineEndsTheDay) {
+  std::string text = "3\n09:00 19:00\n10\n09:41 1 client1\n";
+  std::string sidecar;
+  runPrefix(text, text.size(), sidecar, false);
+  text += "09:30 1 client2\n09:50 1 client3\n";
+  EXPECT_EQ(runPrefix(text, text.size(), sidecar, false),
+            "09:30 1 client2\n");
+  text += "10:00 1 client4\n";
+  EXPECT_EQ(runPrefix(text, text.size(), sidecar, true), "");
+}
+
+TEST(ClubIncrementalTest, RejectsMalformedSidecar) {
+  incremental::Sidecar sidecar;
+  EXPECT_TRUE(incremental::decode("CCIS", sidecar).has_value());
+  EXPECT_TRUE(incremental::decode("nope-nope", sidecar).has_value());
+
+  sidecar.configured = true;
+  sidecar.input_offset = 10;
+  sidecar.state = "not a snapshot";
+  EXPECT_TRUE(incremental::decode(incremental::encode(sidecar), sidecar)
+                  .has_value());
+}
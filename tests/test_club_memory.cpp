@@ -0,0 +1,82 @@
+#include "club_memory.h"
+#include "club_runner.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::int64_t liveBytes(const MemoryReport &report,
+                       MemorySubsystem subsystem) {
+  return report.subsystems[static_cast<std::size_t>(subsystem)].live_bytes;
+}
+
+} // namespace
+
+TEST(ClubMemoryTest, ScopesChargeTheirSubsystem) {
+  if (!isMemoryAccountingSupported()) {
+    GTEST_SKIP() << "no counting allocator on this platform";
+  }
+  enableMemoryAccounting();
+  {
+    MemoryScope queue_scope(MemorySubsystem::QUEUE);
+    auto block = std::make_unique<char[]>(4000);
+    {
+      MemoryScope strings_scope(MemorySubsystem::STRINGS);
+      auto inner = std::make_unique<char[]>(100);
+      EXPECT_GE(liveBytes(readMemoryUsage(), MemorySubsystem::STRINGS), 100);
+    }
+    EXPECT_EQ(current_memory_subsystem, MemorySubsystem::QUEUE);
+    MemoryReport report = readMemoryUsage();
+    EXPECT_GE(liveBytes(report, MemorySubsystem::QUEUE), 4000);
+    EXPECT_EQ(liveBytes(report, MemorySubsystem::STRINGS), 0);
+  }
+  MemoryReport report = readMemoryUsage();
+  disableMemoryAccounting();
+
+  const MemoryUsage &queue =
+      report.subsystems[static_cast<std::size_t>(MemorySubsystem::QUEUE)];
+  EXPECT_EQ(queue.live_bytes, 0);
+  EXPECT_GE(queue.peak_bytes, 4000);
+  EXPECT_EQ(queue.allocations, 1u);
+  EXPECT_EQ(current_memory_subsystem, MemorySubsystem::OTHER);
+}
+
+TEST(ClubMemoryTest, RunReportsEngineSubsystems) {
+  if (!isMemoryAccountingSupported()) {
+    GTEST_SKIP() << "no counting allocator on this platform";
+  }
+  workload::Spec spec;
+  spec.num_tables = 300; // heap-backed tables and queue
+  spec.num_clients = 2000;
+  spec.num_events = 20000;
+  std::istringstream in(workload::generate(spec));
+  std::ostringstream out;
+  MemoryReport report;
+  RunOptions options;
+  options.memory_report = &report;
+
+  enableMemoryAccounting();
+  runTextInput(in, out, options);
+  disableMemoryAccounting();
+
+  EXPECT_EQ(report.events, 20000u);
+  EXPECT_GT(report.clients, 0u);
+  EXPECT_GT(report.engine_object_bytes, 0u);
+  // one Event per incoming event at least
+  EXPECT_GE(liveBytes(report, MemorySubsystem::EVENT_LOG),
+            static_cast<std::int64_t>(20000 * sizeof(Event)));
+  EXPECT_GT(liveBytes(report, MemorySubsystem::TABLE_STATE), 0);
+  EXPECT_GT(liveBytes(report, MemorySubsystem::STRINGS), 0);
+  EXPECT_GT(liveBytes(report, MemorySubsystem::CLIENT_STATE), 0);
+  EXPECT_GE(report.peak_heap_bytes,
+            liveBytes(report, MemorySubsystem::EVENT_LOG));
+
+  std::ostringstream text;
+  writeMemoryReport(report, text);
+  EXPECT_NE(text.str().find("event_log_bytes_per_event "), std::string::npos);
+  EXPECT_NE(text.str().find("events 20000\n"), std::string::npos);
+}
@@ -0,0 +1,174 @@
+#include "club_metrics.h"
+#include "club_runner.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef CLUB_HAS_SHARED_METRICS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// every field of the load carries the same value, so a torn read shows
+struct CounterClub {
+  std::int64_t value = 0;
+  Time close_time = Time(23, 0);
+
+  ClubLoad getLoad() const {
+    return ClubLoad{static_cast<int>(value), static_cast<std::size_t>(value),
+                    static_cast<std::size_t>(value), value};
+  }
+  const Time &getCloseTime() const { return close_time; }
+};
+
+} // namespace
+
+TEST(ClubMetricsTest, RunPublishesFinalFigures) {
+  workload::Spec spec;
+  spec.num_tables = 7;
+  spec.num_events = 5000;
+  std::string text = workload::generate(spec);
+
+  MetricsBlock block;
+  initMetricsBlock(block);
+  MetricsWriter writer(block);
+  RunOptions options;
+  options.metrics = &writer;
+  std::istringstream in(text);
+  std::ostringstream report;
+  runTextInput(in, report, options);
+
+  std::istringstream direct_in(text);
+  SmallComputerClub club;
+  ASSERT_FALSE(club.loadConfiguration(direct_in).has_value());
+  std::string line;
+  while (std::getline(direct_in, line)) {
+    ASSERT_FALSE(club.processEventLine(line).has_value());
+  }
+  club.processEndOfDay();
+  ClubLoad load = club.getLoad();
+  std::int64_t revenue = 0;
+  for (std::int64_t table_revenue : club.getTableTotals().revenue) {
+    revenue += table_revenue;
+  }
+  EXPECT_EQ(load.revenue, revenue);
+
+  MetricsSnapshot snapshot;
+  ASSERT_TRUE(readMetrics(block, snapshot));
+  EXPECT_EQ(snapshot.events_processed, 5000u);
+  EXPECT_EQ(snapshot.num_tables, 7u);
+  EXPECT_EQ(snapshot.occupied_tables,
+            static_cast<std::uint64_t>(load.occupied_tables));
+  EXPECT_EQ(snapshot.queue_length, load.queue_length);
+  EXPECT_EQ(snapshot.clients_inside, load.clients_inside);
+  EXPECT_EQ(snapshot.revenue, static_cast<std::uint64_t>(revenue));
+  EXPECT_EQ(snapshot.last_event_minutes, 23u * 60);
+  EXPECT_TRUE(snapshot.day_finished);
+}
+
+TEST(ClubMetricsTest, ReadersNeverSeeTornWrites) {
+  MetricsBlock block;
+  initMetricsBlock(block);
+  std::atomic<bool> done{false};
+
+  std::thread writer_thread([&] {
+    MetricsWriter writer(block);
+    CounterClub club;
+    for (club.value = 1; club.value <= 200000; ++club.value) {
+      writer.publish(club, Time(static_cast<int>(club.value % 1440)));
+    }
+    done = true;
+  });
+
+  std::uint64_t reads = 0, last_events = 0;
+  while (!done || reads == 0) {
+    MetricsSnapshot snapshot;
+    ASSERT_TRUE(readMetrics(block, snapshot));
+    ASSERT_EQ(snapshot.occupied_tables, snapshot.events_processed);
+    ASSERT_EQ(snapshot.queue_length, snapshot.events_processed);
+    ASSERT_EQ(snapshot.clients_inside, snapshot.events_processed);
+    ASSERT_EQ(snapshot.revenue, snapshot.events_processed);
+    ASSERT_EQ(snapshot.last_event_minutes, snapshot.events_processed % 1440);
+    ASSERT_GE(snapshot.events_processed, last_events);
+    last_events = snapshot.events_processed;
+    ++reads;
+  }
+  writer_thread.join();
+  EXPECT_GT(reads, 0u);
+}
+
+TEST(ClubMetricsTest, RejectsForeignBlock) {
+  MetricsBlock block;
+  initMetricsBlock(block);
+  block.version = MetricsBlock::kVersion + 1;
+  MetricsSnapshot snapshot;
+  EXPECT_FALSE(readMetrics(block, snapshot));
+}
+
+TEST(ClubMetricsTest, GivesUpOnWriterStuckInUpdate) {
+  MetricsBlock block;
+  initMetricsBlock(block);
+  // a writer that died between beginWrite and endWrite
+  block.sequence.store(1);
+  MetricsSnapshot snapshot;
+  EXPECT_FALSE(readMetrics(block, snapshot));
+}
+
+#ifdef CLUB_HAS_SHARED_METRICS
+TEST(ClubMetricsTest, CreateKeepsLiveWriterAndReplacesLeftover) {
+  std::string name = "/club_metrics_owner_" + std::to_string(getpid());
+  {
+    SharedMetricsRegion live;
+    ASSERT_FALSE(live.create(name).has_value());
+    MetricsWriter writer(*live.block());
+    writer.setTableCount(7);
+
+    SharedMetricsRegion second;
+    EXPECT_TRUE(second.create(name).has_value());
+    MetricsSnapshot snapshot;
+    ASSERT_TRUE(readMetrics(*live.block(), snapshot));
+    EXPECT_EQ(snapshot.num_tables, 7u);
+  }
+  // an object nobody holds, as a killed writer leaves it
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT, 0644);
+  ASSERT_GE(fd, 0);
+  ::close(fd);
+  {
+    SharedMetricsRegion replacement;
+    EXPECT_FALSE(replacement.create(name).has_value());
+  }
+  SharedMetricsRegion gone;
+  EXPECT_TRUE(gone.open(name).has_value());
+}
+
+TEST(ClubMetricsTest, SharedRegionIsVisibleToReaders) {
+  std::string name = "/club_metrics_test_" + std::to_string(getpid());
+  {
+    SharedMetricsRegion writer_region;
+    ASSERT_FALSE(writer_region.create(name).has_value());
+    MetricsWriter writer(*writer_region.block());
+    writer.setTableCount(12);
+    CounterClub club;
+    club.value = 5;
+    writer.publish(club, Time(10, 0));
+
+    SharedMetricsRegion reader_region;
+    ASSERT_FALSE(reader_region.open(name).has_value());
+    MetricsSnapshot snapshot;
+    ASSERT_TRUE(readMetrics(*reader_region.block(), snapshot));
+    EXPECT_EQ(snapshot.num_tables, 12u);
+    EXPECT_EQ(snapshot.events_processed, 1u);
+    EXPECT_EQ(snapshot.revenue, 5u);
+  }
+  // the writer unlinks the object when it goes away
+  SharedMetricsRegion gone;
+  EXPECT_TRUE(gone.open(name).has_value());
+}
+#endif
@@ -0,0 +1,205 @@
+#include "club_replay.h"
+#include "club_runner.h"
+#include "club_snapshot.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> eventLines(const std::string &text) {
+  std::istringstream in(text);
+  std::vector<std::string> lines;
+  std::string line;
+  for (int i = 0; i < 3; ++i) {
+    std::getline(in, line);
+  }
+  while (std::getline(in, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+template <typename Club> std::string finishDay(Club &club) {
+  club.processEndOfDay();
+  std::ostringstream report;
+  writeDayReport(club, report, RunOptions{10});
+  return report.str();
+}
+
+// state after all events at or before time, by replaying from the start
+std::string bruteForceState(const std::string &text, const Time &time) {
+  std::istringstream in(text);
+  ComputerClub club;
+  EXPECT_FALSE(club.loadConfiguration(in).has_value());
+  EventStreamState state;
+  std::ostringstream rejected;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (time < Time::parse(line.substr(0, 5)) ||
+        !feedEventLine(club, line, state, rejected)) {
+      break;
+    }
+  }
+  return club_snapshot::encode(club.saveOccupancySnapshot());
+}
+
+template <typename Club> void expectResumeMatches(const std::string &text) {
+  std::vector<std::string> lines = eventLines(text);
+  std::istringstream full_in(text);
+  Club full;
+  ASSERT_FALSE(full.loadConfiguration(full_in).has_value());
+  for (const std::string &line : lines) {
+    ASSERT_FALSE(full.processEventLine(line).has_value());
+  }
+  std::string expected = finishDay(full);
+
+  for (std::size_t split : {std::size_t{0}, lines.size() / 3, lines.size()}) {
+    std::istringstream in(text);
+    Club first;
+    ASSERT_FALSE(first.loadConfiguration(in).has_value());
+    for (std::size_t i = 0; i < split; ++i) {
+      ASSERT_FALSE(first.processEventLine(lines[i]).has_value());
+    }
+    std::string image = club_snapshot::encode(first.saveSnapshot(true));
+
+    ClubStateSnapshot snapshot;
+    ASSERT_FALSE(club_snapshot::decode(image, snapshot).has_value());
+    Club resumed;
+    resumed.restoreSnapshot(snapshot);
+    for (std::size_t i = split; i < lines.size(); ++i) {
+      ASSERT_FALSE(resumed.processEventLine(lines[i]).has_value());
+    }
+    EXPECT_EQ(finishDay(resumed), expected) << "split at " << split;
+  }
+}
+
+std::string workloadText(int tables) {
+  workload::Spec spec;
+  spec.num_tables = tables;
+  spec.num_clients = tables * 4;
+  spec.num_events = 3000;
+  spec.seed = 11;
+  return workload::generate(spec);
+}
+
+} // namespace
+
+TEST(ClubSnapshotTest, RestoredClubContinuesTheDay) {
+  expectResumeMatches<SmallComputerClub>(workloadText(5));
+  expectResumeMatches<ComputerClub>(workloadText(5));
+  expectResumeMatches<ComputerClub>(workloadText(100));
+  expectResumeMatches<SparseComputerClub>(workloadText(100));
+}
+
+TEST(ClubSnapshotTest, MalformedSnapshotsAreRejected) {
+  std::string text = workloadText(4);
+  std::istringstream in(text);
+  ComputerClub club;
+  ASSERT_FALSE(club.loadConfiguration(in).has_value());
+  std::vector<std::string> lines = eventLines(text);
+  for (std::size_t i = 0; i < 500; ++i) {
+    club.processEventLine(lines[i]);
+  }
+  std::string image = club_snapshot::encode(club.saveSnapshot(true));
+
+  ClubStateSnapshot snapshot;
+  for (std::size_t cut = 0; cut < image.size(); cut += 3) {
+    EXPECT_TRUE(club_snapshot::decode(image.substr(0, cut), snapshot))
+        << "cut at " << cut;
+  }
+  EXPECT_TRUE(club_snapshot::decode(image + "x", snapshot).has_value());
+  ASSERT_FALSE(club_snapshot::decode(image, snapshot).has_value());
+  EXPECT_EQ(club_snapshot::encode(snapshot), image);
+}
+
+TEST(ReplayIndexTest, StateAtMatchesReplayFromStart) {
+  std::string text = workloadText(6);
+  for (std::size_t interval : {std::size_t{1}, std::size_t{37},
+                               ReplayIndex::kDefaultEventsPerCheckpoint}) {
+    std::istringstream in(text);
+    ReplayIndex index;
+    ASSERT_FALSE(index.build(in, interval).has_value());
+    EXPECT_EQ(index.getCheckpoints().size(), 1 + 3000 / interval);
+
+    for (Time time : {Time(0, 0), Time(8, 0), Time(9, 1), Time(14, 37),
+                      Time(22, 59), Time(23, 59)}) {
+      ClubStateSnapshot state;
+      ASSERT_FALSE(index.stateAt(in, time, state).has_value());
+      EXPECT_EQ(club_snapshot::encode(state), bruteForceState(text, time))
+          << "interval " << interval << " at " << time.toString();
+    }
+  }
+}
+
+TEST(ReplayIndexTest, StopsAtRejectedLine) {
+  std::string text = "2\n09:00 19:00\n10\n"
+                     "09:10 1 client1\n"
+                     "09:15 2 client1 1\n"
+                     "09:20 x client2\n"
+                     "09:30 1 client3\n";
+  std::istringstream in(text);
+  ReplayIndex index;
+  ASSERT_FALSE(index.build(in, 1).has_value());
+  EXPECT_EQ(index.getCheckpoints().size(), 3u);
+
+  ClubStateSnapshot state;
+  ASSERT_FALSE(index.stateAt(in, Time(23, 0), state).has_value());
+  ASSERT_EQ(state.clients.size(), 1u);
+  EXPECT_EQ(state.clients[0].client_name, "client1");
+  ASSERT_EQ(state.tables.size(), 1u);
+  EXPECT_EQ(state.tables[0].client_name, "client1");
+  EXPECT_EQ(state.tables[0].session_start, Time(9, 15));
+
+  std::istringstream bad_config("x\n09:00 19:00\n10\n");
+  EXPECT_TRUE(index.build(bad_config).has_value());
+}
+
+TEST(ReplayIndexTest, IndexGrowsLinearlyWithTheDay) {
+  // every client comes, plays and leaves, so the occupancy stays small
+  // while the clients seen so far grow with the day; a checkpoint carrying
+  // all of them would make the index quadratic
+  std::size_t bytes_per_checkpoint[2];
+  for (int i = 0; i < 2; ++i) {
+    int num_clients = i == 0 ? 5000 : 20000;
+    std::string text = "10\n08:00 23:00\n10\n";
+    for (int client = 0; client < num_clients; ++client) {
+      std::string time =
+          Time(8 * 60 + client * 15 * 60 / num_clients).toString();
+      std::string name = "client" + std::to_string(client);
+      text += time + " 1 " + name + "\n" + time + " 2 " + name + ' ' +
+              std::to_string(client % 10 + 1) + "\n" + time + " 4 " + name +
+              "\n";
+    }
+    std::istringstream in(text);
+    ReplayIndex index;
+    ASSERT_FALSE(index.build(in, 256).has_value());
+    bytes_per_checkpoint[i] =
+        index.serialize().size() / index.getCheckpoints().size();
+  }
+  EXPECT_LE(bytes_per_checkpoint[1], bytes_per_checkpoint[0] * 3 / 2)
+      << bytes_per_checkpoint[0] << " bytes per checkpoint for a short day, "
+      << bytes_per_checkpoint[1] << " for a four times longer one";
+}
+
+TEST(ReplayIndexTest, SerializedIndexAnswersTheSame) {
+  std::string text = workloadText(3);
+  std::istringstream in(text);
+  ReplayIndex index;
+  ASSERT_FALSE(index.build(in, 100).has_value());
+  std::string data = index.serialize();
+
+  ReplayIndex loaded;
+  ASSERT_FALSE(loaded.deserialize(data).has_value());
+  EXPECT_EQ(loaded.serialize(), data);
+  ClubStateSnapshot expected, actual;
+  ASSERT_FALSE(index.stateAt(in, Time(15, 0), expected).has_value());
+  ASSERT_FALSE(loaded.stateAt(in, Time(15, 0), actual).has_value());
+  EXPECT_EQ(club_snapshot::encode(actual), club_snapshot::encode(expected));
+
+  EXPECT_TRUE(loaded.deserialize(data.substr(0, data.size() / 2)));
+  EXPECT_TRUE(loaded.getCheckpoints().empty());
+}
@@ -0,0 +1,131 @@
+#include "binary_format.h"
+#include "club_rollup.h"
+#include "club_runner.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test_helpers::writeTempFile;
+
+// table statistics lines of the text report, "<id> <revenue> <HH:MM>"
+void addReportStatistics(const std::string &input, TableStatsSummary &sum) {
+  std::istringstream in(input);
+  std::ostringstream out;
+  runTextInput(in, out);
+
+  std::istringstream report(out.str());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(report, line)) {
+    lines.push_back(line);
+  }
+  int num_tables = std::stoi(input.substr(0, input.find('\n')));
+  if (sum.numTables() < num_tables) {
+    sum.minutes_used.resize(num_tables, 0);
+    sum.revenue.resize(num_tables, 0);
+  }
+  for (int i = 0; i < num_tables; ++i) {
+    std::istringstream stat(lines[lines.size() - num_tables + i]);
+    int id, revenue;
+    std::string time;
+    stat >> id >> revenue >> time;
+    sum.revenue[id - 1] += revenue;
+    sum.minutes_used[id - 1] += Time::parse(time).toMinutes();
+  }
+  ++sum.days;
+}
+
+} // namespace
+
+TEST(TableStatsSummaryTest, MergeGrowsToLargerTableCount) {
+  TableStatsSummary a;
+  a.minutes_used = {10, 20};
+  a.revenue = {1, 2};
+  a.days = 1;
+  TableStatsSummary b;
+  b.minutes_used = {1, 2, 3};
+  b.revenue = {10, 20, 30};
+  b.days = 2;
+
+  a.merge(b);
+  EXPECT_EQ(a.numTables(), 3);
+  EXPECT_EQ(a.minutes_used, (std::vector<std::int64_t>{11, 22, 3}));
+  EXPECT_EQ(a.revenue, (std::vector<std::int64_t>{11, 22, 30}));
+  EXPECT_EQ(a.days, 3u);
+}
+
+TEST(TableStatsSummaryTest, EngineTotalsMatchTextStatistics) {
+  ComputerClub club;
+  club.applyConfiguration({3, Time(9, 0), Time(19, 0), 10});
+  club.processEvent(Time(9, 10), 1, "client1");
+  club.processEvent(Time(9, 15), 2, "client1", 2);
+  club.processEvent(Time(11, 16), 4, "client1");
+  club.processEndOfDay();
+
+  TableStatsSummary totals = club.getTableTotals();
+  EXPECT_EQ(totals.days, 1u);
+  EXPECT_EQ(totals.minutes_used, (std::vector<std::int64_t>{0, 121, 0}));
+  EXPECT_EQ(totals.revenue, (std::vector<std::int64_t>{0, 30, 0}));
+}
+
+TEST(ClubRollupTest, ParallelRollupMatchesSummedReports) {
+  std::vector<std::string> paths;
+  TableStatsSummary expected;
+  for (int day = 0; day < 23; ++day) {
+    workload::Spec spec;
+    spec.num_tables = 5 + day % 4;
+    spec.num_clients = 30;
+    spec.num_events = 400;
+    spec.seed = 7 + day;
+    std::string input = workload::generate(spec);
+    addReportStatistics(input, expected);
+
+    std::string name = "rollup_day" + std::to_string(day);
+    if (day % 3 == 0) {
+      std::istringstream text(input);
+      std::ostringstream binary;
+      ASSERT_FALSE(binary_format::convertTextToBinary(text, binary));
+      paths.push_back(writeTempFile(name + ".bin", binary.str()));
+    } else {
+      paths.push_back(writeTempFile(name + ".txt", input));
+    }
+  }
+
+  for (unsigned threads : {1u, 2u, 5u, 64u}) {
+    RollupResult result = rollupDayFiles(paths, threads);
+    EXPECT_TRUE(result.skipped_files.empty());
+    EXPECT_EQ(result.totals.days, expected.days);
+    EXPECT_EQ(result.totals.minutes_used, expected.minutes_used);
+    EXPECT_EQ(result.totals.revenue, expected.revenue);
+  }
+}
+
+TEST(ClubRollupTest, DaysWithoutStatisticsAreSkipped) {
+  std::vector<std::string> paths = {
+      writeTempFile("rollup_good.txt", "2\n09:00 19:00\n10\n"
+                                       "09:10 1 client1\n09:15 2 client1 1\n"),
+      writeTempFile("rollup_bad_line.txt", "2\n09:00 19:00\n10\n"
+                                           "09:10 1 client1\n9:20 2 x 1\n"),
+      writeTempFile("rollup_bad_config.txt", "2\n19:00 09:00\n10\n"),
+      ::testing::TempDir() + "rollup_missing.txt"};
+
+  RollupResult result = rollupDayFiles(paths, 2);
+  EXPECT_EQ(result.totals.days, 1u);
+  EXPECT_EQ(result.totals.minutes_used, (std::vector<std::int64_t>{585, 0}));
+  EXPECT_EQ(result.totals.revenue, (std::vector<std::int64_t>{100, 0}));
+  EXPECT_EQ(result.skipped_files,
+            (std::vector<std::string>{paths[1], paths[2], paths[3]}));
+
+  std::ostringstream report;
+  writeRollupReport(result.totals, report);
+  EXPECT_EQ(report.str(), "1 100 09:45\n2 0 00:00\n");
+  // the stream keeps its own fill for what the caller writes next
+  EXPECT_EQ(report.fill(), ' ');
+}
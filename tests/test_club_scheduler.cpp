@@ -0,0 +1,116 @@
+#include "club_runner.h"
+#include "club_scheduler.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#ifdef CLUB_HAS_FD_SOURCES
+#include <unistd.h>
+#endif
+
+using test_helpers::runText;
+using test_helpers::splitLines;
+
+TEST(ClubSchedulerTest, InterleavedClubsMatchSequentialRuns) {
+  const int num_clubs = 50;
+  std::vector<std::string> inputs;
+  for (int i = 0; i < num_clubs; ++i) {
+    workload::Spec spec;
+    spec.num_tables = 1 + i % 7;
+    spec.num_clients = 10 + i;
+    spec.num_events = 300 + 17 * i;
+    spec.seed = 100 + i;
+    inputs.push_back(workload::generate(spec));
+  }
+  // a club that stops on a malformed line and one with a bad configuration
+  inputs.push_back("2\n09:00 19:00\n10\n09:10 1 client1\n09:20 x client1\n"
+                   "09:30 1 client2\n");
+  inputs.push_back("2\n19:00 09:00\n10\n09:10 1 client1\n");
+
+  ClubScheduler scheduler;
+  std::vector<std::unique_ptr<MemoryLineSource>> sources;
+  std::vector<std::ostringstream> outputs(inputs.size());
+  std::vector<std::vector<std::string>> pending;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    sources.push_back(std::make_unique<MemoryLineSource>(8));
+    scheduler.spawn(runClubStream(scheduler, *sources[i], outputs[i]));
+    pending.push_back(splitLines(inputs[i]));
+  }
+
+  // feed a few lines per club per round, like interleaved live feeds
+  std::vector<std::size_t> next(inputs.size(), 0);
+  bool fed_any = true;
+  while (fed_any) {
+    fed_any = false;
+    for (std::size_t i = 0; i < inputs.size(); ++i) {
+      for (int k = 0; k < 5 && next[i] < pending[i].size(); ++k) {
+        if (!sources[i]->push(pending[i][next[i]])) {
+          break;
+        }
+        ++next[i];
+        fed_any = true;
+      }
+      if (next[i] == pending[i].size()) {
+        sources[i]->close();
+      }
+    }
+    scheduler.run();
+  }
+  ASSERT_TRUE(scheduler.run());
+
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    ASSERT_EQ(outputs[i].str(), runText(inputs[i])) << "club " << i;
+  }
+}
+
+TEST(ClubSchedulerTest, WaitsForMoreInput) {
+  ClubScheduler scheduler;
+  MemoryLineSource source;
+  std::ostringstream output;
+  scheduler.spawn(runClubStream(scheduler, source, output));
+
+  source.push("1");
+  ASSERT_FALSE(scheduler.run());
+  ASSERT_TRUE(output.str().empty());
+
+  source.push("09:00 19:00");
+  source.push("10");
+  source.push("09:05 1 client1");
+  ASSERT_FALSE(scheduler.run());
+  ASSERT_EQ(output.str(), "09:00\n");
+
+  source.close();
+  ASSERT_TRUE(scheduler.run());
+  ASSERT_EQ(output.str(), runText("1\n09:00 19:00\n10\n09:05 1 client1\n"));
+}
+
+#ifdef CLUB_HAS_FD_SOURCES
+TEST(ClubSchedulerTest, PipeBackedSources) {
+  const std::string inputs[] = {
+      "3\n09:00 19:00\n10\n09:41 1 client1\n09:54 2 client1 1\n"
+      "12:33 4 client1",
+      "1\n10:00 20:00\n5\n10:00 1 a\n10:05 2 a 1\n10:06 1 b\n10:07 3 b\n"};
+
+  ClubScheduler scheduler;
+  std::vector<std::unique_ptr<FdLineSource>> sources;
+  std::ostringstream outputs[2];
+  for (int i = 0; i < 2; ++i) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], inputs[i].data(), inputs[i].size()),
+              static_cast<ssize_t>(inputs[i].size()));
+    close(fds[1]);
+    sources.push_back(std::make_unique<FdLineSource>(fds[0], 16));
+    scheduler.spawn(runClubStream(scheduler, *sources.back(), outputs[i]));
+  }
+
+  ASSERT_TRUE(scheduler.run());
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(outputs[i].str(), runText(inputs[i]));
+  }
+}
+#endif
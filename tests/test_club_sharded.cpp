@@ -0,0 +1,143 @@
+#include "club_runner.h"
+#include "club_sharded.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using test_helpers::splitLines;
+
+struct ClubInput {
+  std::string club_id;
+  std::string text;
+};
+
+// random interleaving that keeps the line order of every club
+std::string interleave(const std::vector<ClubInput> &clubs, unsigned seed) {
+  std::vector<std::vector<std::string>> lines;
+  std::vector<std::size_t> next(clubs.size(), 0);
+  std::size_t remaining = 0;
+  for (const ClubInput &club : clubs) {
+    lines.push_back(splitLines(club.text));
+    remaining += lines.back().size();
+  }
+  std::mt19937 rng(seed);
+  std::string stream;
+  while (remaining > 0) {
+    std::size_t club = rng() % clubs.size();
+    if (next[club] == lines[club].size()) {
+      continue;
+    }
+    stream += clubs[club].club_id + ' ' + lines[club][next[club]++] + '\n';
+    --remaining;
+  }
+  return stream;
+}
+
+std::map<std::string, std::string> runSharded(const std::string &stream,
+                                              unsigned num_workers,
+                                              ShardedRunResult &result) {
+  std::map<std::string, std::string> reports;
+  std::mutex reports_mutex;
+  std::istringstream in(stream);
+  result = runShardedInput(
+      in, num_workers,
+      [&](const std::string &club_id, const std::string &report) {
+        std::lock_guard lock(reports_mutex);
+        return reports.emplace(club_id, report).second;
+      });
+  return reports;
+}
+
+std::string singleClubReport(const std::string &text) {
+  std::istringstream in(text);
+  std::ostringstream out;
+  runTextInput(in, out);
+  return out.str();
+}
+
+std::string generated(int num_tables, int num_clients, unsigned seed) {
+  workload::Spec spec;
+  spec.num_tables = num_tables;
+  spec.num_clients = num_clients;
+  spec.num_events = 3000;
+  spec.seed = seed;
+  return workload::generate(spec);
+}
+
+} // namespace
+
+TEST(ClubShardedTest, EveryClubMatchesItsOwnRun) {
+  std::string rejected_day = generated(4, 30, 5);
+  rejected_day.insert(rejected_day.find('\n', rejected_day.size() / 2) + 1,
+                      "12:00 9 client1\n");
+  std::string out_of_order_day = generated(2, 10, 6) + "08:00 1 late\n";
+  std::vector<ClubInput> clubs = {
+      {"small", generated(3, 20, 1)},
+      {"medium-1", generated(65, 300, 2)},
+      {"big_club", generated(500, 2000, 3)},
+      {"bad_config", "0\n09:00 21:00\n10\n09:00 1 a\n"},
+      {"short", "5\n09:00 21:00\n"},
+      {"rejected", rejected_day},
+      {"out_of_order", out_of_order_day},
+  };
+  std::string stream = interleave(clubs, 11);
+
+  for (unsigned num_workers : {1u, 2u, 4u}) {
+    SCOPED_TRACE(num_workers);
+    ShardedRunResult result;
+    std::map<std::string, std::string> reports =
+        runSharded(stream, num_workers, result);
+    EXPECT_EQ(result.clubs, clubs.size());
+    EXPECT_TRUE(result.invalid_lines.empty());
+    EXPECT_TRUE(result.failed_clubs.empty());
+    ASSERT_EQ(reports.size(), clubs.size());
+    for (const ClubInput &club : clubs) {
+      EXPECT_EQ(reports[club.club_id], singleClubReport(club.text))
+          << club.club_id;
+    }
+  }
+}
+
+TEST(ClubShardedTest, LinesWithoutClubIdAreSkipped) {
+  std::string stream = "a 1\n"
+                       "a 09:00 10:00\n"
+                       "\n"
+                       "bad/id 3\n"
+                       " 09:00 1 x\n"
+                       "a 10\n"
+                       "a\n"
+                       "a 09:10 1 client\n";
+  ShardedRunResult result;
+  std::map<std::string, std::string> reports = runSharded(stream, 2, result);
+  EXPECT_EQ(result.invalid_lines, (std::vector<std::size_t>{4, 5}));
+  ASSERT_EQ(reports.size(), 1u);
+  // "a" alone is an empty line of club a and is ignored like in a file
+  EXPECT_EQ(reports["a"], singleClubReport("1\n09:00 10:00\n10\n\n"
+                                           "09:10 1 client\n"));
+}
+
+TEST(ClubShardedTest, SinkFailuresAreReported) {
+  std::istringstream in("x 1\ny 1\n");
+  ShardedRunResult result = runShardedInput(
+      in, 2, [](const std::string &club_id, const std::string &) {
+        return club_id != "y";
+      });
+  EXPECT_EQ(result.clubs, 2u);
+  EXPECT_EQ(result.failed_clubs, std::vector<std::string>{"y"});
+}
+
+TEST(ClubShardedTest, ClubIdValidation) {
+  EXPECT_TRUE(isValidClubId("club-7_A"));
+  EXPECT_FALSE(isValidClubId(""));
+  EXPECT_FALSE(isValidClubId("../etc"));
+  EXPECT_FALSE(isValidClubId(std::string(kMaxClubIdLength + 1, 'a')));
+}
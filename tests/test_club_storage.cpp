@@ -0,0 +1,186 @@
+#include "computer_club.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+TEST(TableSetTest, FixedOccupancyMask) {
+  TableSet<kSmallClubTables> tables;
+  tables.reset(3);
+  ASSERT_EQ(tables.size(), 3);
+  ASSERT_EQ(tables.findFree(), 1);
+
+  tables.occupy(1, 0, Time(10, 0));
+  tables.occupy(2, 1, Time(10, 0));
+  ASSERT_TRUE(tables.isOccupied(1));
+  ASSERT_EQ(tables.findFree(), 3);
+
+  tables.occupy(3, 2, Time(10, 0));
+  ASSERT_EQ(tables.findFree(), 0);
+
+  tables.free(2, Time(11, 30), 10);
+  ASSERT_FALSE(tables.isOccupied(2));
+  ASSERT_EQ(tables.findFree(), 2);
+  ASSERT_EQ(tables.clientId(2), ClientRegistry::kNoClient);
+  ASSERT_EQ(tables.minutesUsed(2), 90);
+  ASSERT_EQ(tables.revenueGenerated(2), 20);
+}
+
+TEST(TableSetTest, FixedFullWord) {
+  TableSet<kSmallClubTables> tables;
+  tables.reset(64);
+  for (int id = 1; id <= 63; ++id) {
+    tables.occupy(id, 0, Time(10, 0));
+  }
+  ASSERT_EQ(tables.findFree(), 64);
+  tables.occupy(64, 0, Time(10, 0));
+  ASSERT_EQ(tables.findFree(), 0);
+}
+
+TEST(TableSetTest, DynamicBitmapAcrossWords) {
+  TableSet<kDynamicTables> tables;
+  tables.reset(130);
+  for (int id = 1; id <= 130; ++id) {
+    if (id != 129) {
+      tables.occupy(id, 7, Time(9, 0));
+    }
+  }
+  ASSERT_EQ(tables.findFree(), 129);
+  tables.free(65, Time(9, 59), 10);
+  ASSERT_EQ(tables.findFree(), 65);
+  ASSERT_EQ(tables.sessionStart(66).toString(), "09:00");
+  ASSERT_EQ(tables.clientId(66), 7u);
+  ASSERT_EQ(tables.minutesUsed(65), 59);
+}
+
+TEST(ClientRegistryTest, InternIsStable) {
+  ClientRegistry registry;
+  std::uint32_t first = registry.intern("client1");
+  for (int i = 0; i < 1000; ++i) {
+    registry.intern("client" + std::to_string(i));
+  }
+  ASSERT_EQ(registry.intern("client1"), first);
+  ASSERT_EQ(registry.find("client1"), first);
+  ASSERT_EQ(registry.name(first), "client1");
+  ASSERT_EQ(registry.find("unknown"), ClientRegistry::kNoClient);
+  ASSERT_EQ(registry.size(), 1000u);
+}
+
+TEST(WaitingQueueTest, RingKeepsOrderAcrossWrap) {
+  WaitingQueue<4> queue;
+  for (int round = 0; round < 3; ++round) {
+    queue.push_back("a");
+    queue.push_back("b");
+    queue.push_back("c");
+    queue.erase("b");
+    ASSERT_EQ(queue.size(), 2u);
+    ASSERT_TRUE(queue.contains("c"));
+    ASSERT_FALSE(queue.contains("b"));
+    ASSERT_EQ(queue.front(), "a");
+    queue.pop_front();
+    ASSERT_EQ(queue.front(), "c");
+    queue.pop_front();
+    ASSERT_TRUE(queue.empty());
+  }
+}
+
+namespace {
+
+template <typename Club> std::string runEngine(const std::string &text) {
+  std::istringstream input(text);
+  Club club;
+  EXPECT_FALSE(club.loadConfiguration(input).has_value());
+
+  std::string output;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (club.processEventLine(line).has_value()) {
+      output += "rejected: " + line + "\n";
+    }
+  }
+  club.processEndOfDay();
+  for (const auto &event : club.getEventLog()) {
+    output += event.toString() + "\n";
+  }
+  std::string statistics;
+  for (const auto &stat : club.getTableStatistics()) {
+    statistics += stat + "\n";
+  }
+  std::ostringstream streamed;
+  club.writeTableStatistics(streamed);
+  EXPECT_EQ(streamed.str(), statistics);
+  return output + statistics;
+}
+
+} // namespace
+
+TEST(ClubEngineTest, StorageVariantsAgree) {
+  workload::Spec spec;
+  spec.num_tables = 5;
+  spec.num_clients = 20;
+  spec.num_events = 5000;
+  std::string text = workload::generate(spec);
+
+  std::string expected = runEngine<ComputerClub>(text);
+  ASSERT_EQ(runEngine<SmallComputerClub>(text), expected);
+  ASSERT_EQ(runEngine<SparseComputerClub>(text), expected);
+}
+
+TEST(ClubEngineTest, SparseEngineUntouchedTables) {
+  std::string text = "100000\n09:00 19:00\n10\n"
+                     "09:10 1 client1\n"
+                     "09:20 2 client1 99999\n"
+                     "09:30 1 client2\n"
+                     "09:40 3 client2\n";
+  std::string output = runEngine<SparseComputerClub>(text);
+  ASSERT_NE(output.find("09:40 13 ICanWaitNoLonger!"), std::string::npos);
+  ASSERT_NE(output.find("\n99999 100 09:40\n"), std::string::npos);
+  ASSERT_NE(output.find("\n100000 0 00:00\n"), std::string::npos);
+}
+
+TEST(TableSetTest, SparseFreeSearch) {
+  TableSet<kSparseTables> tables;
+  tables.reset(1000000000);
+  ASSERT_EQ(tables.findFree(), 1);
+
+  tables.occupy(1, 0, Time(9, 0));
+  tables.occupy(2, 1, Time(9, 0));
+  tables.occupy(5, 2, Time(9, 0));
+  ASSERT_EQ(tables.findFree(), 3);
+  ASSERT_TRUE(tables.isOccupied(5));
+  ASSERT_FALSE(tables.isOccupied(3));
+
+  tables.free(2, Time(9, 30), 10);
+  ASSERT_EQ(tables.findFree(), 2);
+  ASSERT_EQ(tables.minutesUsed(2), 30);
+  ASSERT_EQ(tables.minutesUsed(4), 0);
+
+  TableSet<kSparseTables> tiny;
+  tiny.reset(2);
+  tiny.occupy(2, 0, Time(9, 0));
+  tiny.occupy(1, 1, Time(9, 0));
+  ASSERT_EQ(tiny.findFree(), 0);
+  tiny.free(2, Time(10, 0), 10);
+  ASSERT_EQ(tiny.findFree(), 2);
+}
+
+TEST(ClubEngineTest, TableInfoView) {
+  ComputerClub club;
+  std::istringstream config("2\n09:00 19:00\n10\n");
+  ASSERT_FALSE(club.loadConfiguration(config).has_value());
+  club.processEventLine("09:10 1 client1");
+  club.processEventLine("09:15 2 client1 2");
+
+  TableInfo busy = club.getTableInfo(2);
+  ASSERT_EQ(busy.id, 2);
+  ASSERT_TRUE(busy.is_occupied);
+  ASSERT_EQ(busy.current_client_name, "client1");
+  ASSERT_EQ(busy.session_start_time.toString(), "09:15");
+
+  club.processEventLine("10:20 4 client1");
+  TableInfo freed = club.getTableInfo(2);
+  ASSERT_FALSE(freed.is_occupied);
+  ASSERT_TRUE(freed.current_client_name.empty());
+  ASSERT_EQ(freed.total_minutes_used, 65);
+  ASSERT_EQ(freed.revenue_generated, 20);
+}
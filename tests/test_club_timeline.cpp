@@ -0,0 +1,102 @@
+#include "club_runner.h"
+#include "club_timeline.h"
+#include "computer_club.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(OccupancyTimelineTest, CurveFollowsTablesAndQueue) {
+  std::istringstream in("1\n09:00 12:00\n10\n"
+                        "09:00 1 alice\n"
+                        "09:00 1 bob\n"
+                        "09:05 2 alice 1\n"
+                        "09:10 3 bob\n"
+                        "10:00 4 alice\n");
+  SmallComputerClub club;
+  ASSERT_FALSE(club.loadConfiguration(in).has_value());
+  std::string line;
+  while (std::getline(in, line)) {
+    ASSERT_FALSE(club.processEventLine(line).has_value());
+  }
+  club.processEndOfDay();
+
+  OccupancyCurve curve = club.getOccupancyCurve();
+  EXPECT_EQ(curve.open_minutes, 9 * 60);
+  ASSERT_EQ(curve.occupied_tables.size(), 180u);
+  ASSERT_EQ(curve.queue_length.size(), 180u);
+  for (std::size_t minute = 0; minute < 180; ++minute) {
+    SCOPED_TRACE(minute);
+    EXPECT_EQ(curve.occupied_tables[minute], minute < 5 ? 0u : 1u);
+    // bob queues at 09:10 and takes the table at 10:00
+    EXPECT_EQ(curve.queue_length[minute], minute >= 10 && minute < 60);
+  }
+}
+
+TEST(OccupancyTimelineTest, MatchesLoadSampledAfterEveryEvent) {
+  workload::Spec spec;
+  spec.num_tables = 5;
+  spec.num_clients = 60;
+  spec.num_events = 20000;
+  std::istringstream in(workload::generate(spec));
+  ComputerClub club;
+  ASSERT_FALSE(club.loadConfiguration(in).has_value());
+
+  const int open = club.getOpenTime().toMinutes();
+  const int close = club.getCloseTime().toMinutes();
+  std::vector<std::uint32_t> occupied(close - open, 0);
+  std::vector<std::uint32_t> queued(close - open, 0);
+  int filled_until = open;
+  ClubLoad load;
+  std::string line;
+  while (std::getline(in, line)) {
+    ASSERT_FALSE(club.processEventLine(line).has_value());
+    int minute = club.getEventLog().back().event_time.toMinutes();
+    for (; filled_until < minute; ++filled_until) {
+      occupied[filled_until - open] = load.occupied_tables;
+      queued[filled_until - open] = load.queue_length;
+    }
+    load = club.getLoad();
+  }
+  for (; filled_until < close; ++filled_until) {
+    occupied[filled_until - open] = load.occupied_tables;
+    queued[filled_until - open] = load.queue_length;
+  }
+
+  OccupancyCurve curve = club.getOccupancyCurve();
+  EXPECT_EQ(curve.occupied_tables, occupied);
+  EXPECT_EQ(curve.queue_length, queued);
+}
+
+TEST(OccupancyTimelineTest, RunFillsCurveAndFormatsRoundTrip) {
+  workload::Spec spec;
+  spec.num_tables = 200;
+  spec.num_clients = 2000;
+  spec.num_events = 10000;
+  std::istringstream in(workload::generate(spec));
+  std::ostringstream out;
+  OccupancyCurve curve;
+  RunOptions options;
+  options.occupancy = &curve;
+  runTextInput(in, out, options);
+  ASSERT_EQ(curve.occupied_tables.size(), 15u * 60);
+
+  OccupancyCurve decoded;
+  std::string data = occupancy_format::encode(curve);
+  ASSERT_FALSE(occupancy_format::decode(data, decoded).has_value());
+  EXPECT_EQ(decoded, curve);
+  EXPECT_TRUE(
+      occupancy_format::decode(data.substr(0, data.size() - 1), decoded)
+          .has_value());
+  EXPECT_TRUE(occupancy_format::decode(data + '\0', decoded).has_value());
+  EXPECT_TRUE(occupancy_format::decode("CCXX", decoded).has_value());
+
+  std::ostringstream csv;
+  occupancy_format::writeCsv(curve, csv);
+  std::string first_rows = "minute,occupied_tables,queue_length\n08:00," +
+                           std::to_string(curve.occupied_tables[0]) + ',' +
+                           std::to_string(curve.queue_length[0]) + '\n';
+  EXPECT_EQ(csv.str().substr(0, first_rows.size()), first_rows);
+}
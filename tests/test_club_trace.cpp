@@ -0,0 +1,129 @@
+#include "binary_format.h"
+#include "club_runner.h"
+#include "club_trace.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string runText(const std::string &text, Tracer *tracer) {
+  RunOptions options;
+  options.top_spenders = 3;
+  options.trace = tracer;
+  std::istringstream in(text);
+  std::ostringstream out;
+  EXPECT_EQ(runTextInput(in, out, options), 0);
+  return out.str();
+}
+
+std::string runBinary(const std::string &text, Tracer *tracer) {
+  std::istringstream text_in(text);
+  std::ostringstream binary;
+  EXPECT_FALSE(
+      binary_format::convertTextToBinary(text_in, binary).has_value());
+  RunOptions options;
+  options.trace = tracer;
+  std::istringstream in(binary.str());
+  std::ostringstream out, errors;
+  EXPECT_EQ(runBinaryInput(in, out, errors, options), 0);
+  return out.str();
+}
+
+std::string generateDay(int num_events) {
+  workload::Spec spec;
+  spec.num_tables = 5;
+  spec.num_events = num_events;
+  return workload::generate(spec);
+}
+
+// replaces line number `index` (0-based, counting the header) of text
+std::string replaceLine(const std::string &text, int index,
+                        const std::string &line) {
+  std::istringstream in(text);
+  std::string result, current;
+  for (int i = 0; std::getline(in, current); ++i) {
+    result += (i == index ? line : current) + '\n';
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(ClubTraceTest, TracedRunPrintsTheSameReport) {
+  // several batches, with empty lines inside them
+  std::string text = replaceLine(generateDay(10000), 5000, "");
+  Tracer tracer;
+  EXPECT_EQ(runText(text, &tracer), runText(text, nullptr));
+  EXPECT_EQ(runBinary(text, &tracer), runBinary(text, nullptr));
+}
+
+TEST(ClubTraceTest, TracedRunStopsAtTheSameRejectedLine) {
+  std::string day = generateDay(10000);
+  for (const std::string &bad_line :
+       {std::string("25:00 1 client"), std::string("00:01 1 client"),
+        std::string("12:00 2 client 99")}) {
+    std::string text = replaceLine(day, 6000, bad_line);
+    Tracer tracer;
+    std::string traced = runText(text, &tracer);
+    EXPECT_EQ(traced, runText(text, nullptr));
+    EXPECT_EQ(traced.substr(traced.find('\n') + 1), bad_line + '\n');
+    EXPECT_EQ(runBinary(text, &tracer), runBinary(text, nullptr));
+  }
+}
+
+TEST(ClubTraceTest, TraceHasSpansOfEveryStage) {
+  Tracer tracer(1 << 16, 1);
+  runText(generateDay(100), &tracer);
+  std::ostringstream json;
+  ASSERT_FALSE(tracer.writeChromeTrace(json).has_value());
+
+  std::string trace = json.str();
+  EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+  for (const char *stage :
+       {"load config", "read", "parse", "dispatch", "handleClientArrived",
+        "processEndOfDay", "statistics", "write output"}) {
+    EXPECT_NE(trace.find("\"name\":\"" + std::string(stage) + '"'),
+              std::string::npos)
+        << stage;
+  }
+}
+
+TEST(ClubTraceTest, RingKeepsTheNewestSpans) {
+  TraceRing ring(3, 0);
+  for (std::uint64_t i = 0; i < 10; ++i) {
+    ring.push(TraceSpan{"span", i, i + 1});
+  }
+  std::vector<TraceSpan> spans = ring.spans();
+  ASSERT_EQ(spans.size(), 4u);
+  EXPECT_EQ(spans.front().start_ns, 6u);
+  EXPECT_EQ(spans.back().start_ns, 9u);
+  EXPECT_EQ(ring.overwritten(), 6u);
+}
+
+TEST(ClubTraceTest, EveryThreadRecordsIntoItsOwnRing) {
+  Tracer tracer;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&tracer] {
+      for (int i = 0; i < 1000; ++i) {
+        TraceScope span(&tracer, "work");
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(tracer.spanCount(), 4000u);
+
+  std::ostringstream json;
+  ASSERT_FALSE(tracer.writeChromeTrace(json).has_value());
+  for (int tid = 0; tid < 4; ++tid) {
+    EXPECT_NE(json.str().find("\"name\":\"thread " + std::to_string(tid)),
+              std::string::npos);
+  }
+}
@@ -0,0 +1,152 @@
+#include "club_runner.h"
+#include "event_archive.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<Event> runDay(const std::string &text) {
+  std::istringstream in(text);
+  ClubConfig config;
+  EXPECT_FALSE(loadClubConfiguration(in, config).has_value());
+  ComputerClub club;
+  club.applyConfiguration(config);
+  EventStreamState state;
+  std::ostringstream rejected;
+  std::string line;
+  while (std::getline(in, line)) {
+    EXPECT_TRUE(feedEventLine(club, line, state, rejected));
+  }
+  club.processEndOfDay();
+  return club.getEventLog();
+}
+
+std::string toText(const std::vector<Event> &events) {
+  std::string text;
+  for (const Event &event : events) {
+    text += event.toString() + '\n';
+  }
+  return text;
+}
+
+} // namespace
+
+TEST(EventArchiveTest, ErrorCodesCoverEngineMessages) {
+  for (const char *message : {"YouShallNotPass", "NotOpenYet", "PlaceIsBusy",
+                              "ClientUnknown", "ICanWaitNoLonger!"}) {
+    event_archive::ErrorCode code = event_archive::errorCodeOf(message);
+    EXPECT_NE(code, event_archive::ErrorCode::OTHER);
+    EXPECT_STREQ(event_archive::errorMessageOf(code), message);
+  }
+  EXPECT_EQ(event_archive::errorCodeOf("Oops"),
+            event_archive::ErrorCode::OTHER);
+}
+
+TEST(EventArchiveTest, RoundTripIsExactText) {
+  workload::Spec spec;
+  spec.num_events = 5000;
+  std::vector<Event> log = runDay(workload::generate(spec));
+  log.push_back(Event::newErrorEvent(Time(23, 59), "Oops"));
+  log.push_back(Event::newClientEvent(Time(0, 1), 11, "early"));
+
+  for (std::size_t block_size : {std::size_t{1}, std::size_t{100},
+                                 event_archive::kDefaultEventsPerBlock}) {
+    std::string image = event_archive::writeArchive(log, block_size);
+    event_archive::Reader reader;
+    ASSERT_FALSE(reader.open(image).has_value());
+    EXPECT_EQ(reader.size(), log.size());
+
+    std::vector<Event> decoded;
+    ASSERT_FALSE(reader.readAll(decoded).has_value());
+    EXPECT_EQ(toText(decoded), toText(log));
+  }
+}
+
+TEST(EventArchiveTest, BlocksDecodeIndependently) {
+  workload::Spec spec;
+  spec.num_events = 3000;
+  std::vector<Event> log = runDay(workload::generate(spec));
+  std::string image = event_archive::writeArchive(log, 256);
+
+  event_archive::Reader reader;
+  ASSERT_FALSE(reader.open(image).has_value());
+  const auto &blocks = reader.getBlocks();
+  ASSERT_GT(blocks.size(), 3u);
+
+  // last block first, then every block on its own
+  std::size_t first_event = 0;
+  for (std::size_t i = 0; i + 1 < blocks.size(); ++i) {
+    first_event += blocks[i].num_events;
+  }
+  for (std::size_t i = blocks.size(); i-- > 0;) {
+    std::vector<Event> events;
+    ASSERT_FALSE(reader.readBlock(i, events).has_value());
+    ASSERT_EQ(events.size(), blocks[i].num_events);
+    EXPECT_EQ(events.front().event_time, blocks[i].first_time);
+    EXPECT_EQ(toText(events),
+              toText(std::vector<Event>(
+                  log.begin() + first_event,
+                  log.begin() + first_event + events.size())));
+    if (i > 0) {
+      first_event -= blocks[i - 1].num_events;
+    }
+  }
+}
+
+TEST(EventArchiveTest, MalformedArchivesAreRejected) {
+  std::vector<Event> log = {
+      Event::newClientEvent(Time(9, 0), 1, "client1"),
+      Event::newClientTableEvent(Time(9, 5), 2, "client1", 1),
+      Event::newErrorEvent(Time(9, 6), "PlaceIsBusy")};
+  std::string image = event_archive::writeArchive(log);
+
+  event_archive::Reader reader;
+  EXPECT_TRUE(reader.open("").has_value());
+  EXPECT_TRUE(reader.open("CCEB" + image.substr(4)).has_value());
+  for (std::size_t cut = 0; cut < image.size(); ++cut) {
+    std::string truncated = image.substr(0, cut);
+    std::vector<Event> events;
+    EXPECT_TRUE(reader.open(truncated).has_value() ||
+                reader.readAll(events).has_value())
+        << "cut at " << cut;
+  }
+
+  std::string corrupted = image;
+  corrupted[5] = static_cast<char>(0x7F); // event id of the first record
+  std::vector<Event> events;
+  ASSERT_FALSE(reader.open(corrupted).has_value());
+  EXPECT_TRUE(reader.readAll(events).has_value());
+}
+
+TEST(EventArchiveTest, ArchiveDayLogMatchesReport) {
+  workload::Spec spec;
+  spec.num_events = 2000;
+  std::string text = workload::generate(spec);
+
+  std::istringstream in(text);
+  std::ostringstream archive;
+  ASSERT_FALSE(event_archive::archiveDayLog(in, archive).has_value());
+
+  std::istringstream archive_in(archive.str());
+  std::ostringstream decompressed;
+  ASSERT_FALSE(
+      event_archive::decompressToText(archive_in, decompressed).has_value());
+
+  // report is the open time, the event log, the close time and statistics
+  std::istringstream report_in(text);
+  std::ostringstream report;
+  runTextInput(report_in, report);
+  std::string expected = report.str();
+  expected = expected.substr(expected.find('\n') + 1);
+  EXPECT_EQ(expected.compare(0, decompressed.str().size(), decompressed.str()),
+            0);
+  EXPECT_LT(archive.str().size() * 3, decompressed.str().size());
+
+  std::istringstream stopped("1\n09:00 19:00\n10\n09:10 1 client1\nbad\n");
+  std::ostringstream unused;
+  EXPECT_TRUE(event_archive::archiveDayLog(stopped, unused).has_value());
+}
@@ -0,0 +1,141 @@
+#include "club_runner.h"
+#include "event_archive.h"
+#include "event_index.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<Event> dayLog(int num_events) {
+  workload::Spec spec;
+  spec.num_tables = 8;
+  spec.num_clients = 40;
+  spec.num_events = num_events;
+  std::istringstream input(workload::generate(spec));
+  std::optional<std::vector<Event>> log = collectEventLog(input);
+  EXPECT_TRUE(log.has_value());
+  return log.value_or(std::vector<Event>{});
+}
+
+template <typename Pred>
+EventLogIndex::Postings scan(const std::vector<Event> &log, Pred pred) {
+  EventLogIndex::Postings positions;
+  for (std::uint32_t i = 0; i < log.size(); ++i) {
+    if (pred(log[i])) {
+      positions.push_back(i);
+    }
+  }
+  return positions;
+}
+
+void expectMatchesScan(const EventLogIndex &index,
+                       const std::vector<Event> &log) {
+  ASSERT_EQ(index.size(), log.size());
+  for (int k = 0; k < 45; ++k) {
+    std::string name = "client" + std::to_string(k);
+    EXPECT_EQ(index.clientEvents(name),
+              scan(log, [&](const Event &e) { return e.client_name == name; }))
+        << name;
+  }
+  for (int table_id = 1; table_id <= 9; ++table_id) {
+    EXPECT_EQ(index.tableEvents(table_id),
+              scan(log, [&](const Event &e) {
+                return e.table_id_val == table_id;
+              }));
+  }
+  for (auto [from, to] : {std::pair{Time(0, 0), Time(23, 59)},
+                          std::pair{Time(9, 0), Time(9, 0)},
+                          std::pair{Time(12, 30), Time(14, 37)},
+                          std::pair{Time(22, 0), Time(22, 0)},
+                          std::pair{Time(23, 0), Time(23, 59)},
+                          std::pair{Time(15, 0), Time(14, 0)}}) {
+    EventLogIndex::Postings expected = scan(log, [&](const Event &e) {
+      return from <= e.event_time && e.event_time <= to;
+    });
+    EXPECT_EQ(index.timeRange(from, to), expected)
+        << from.toString() << "-" << to.toString();
+  }
+}
+
+} // namespace
+
+TEST(EventLogIndexTest, LookupsMatchFullScan) {
+  std::vector<Event> log = dayLog(20000);
+  EventLogIndex index;
+  index.catchUp(log);
+  expectMatchesScan(index, log);
+  EXPECT_TRUE(index.clientEvents("nobody").empty());
+  EXPECT_TRUE(index.tableEvents(1000).empty());
+}
+
+TEST(EventLogIndexTest, CatchUpIndexesOnlyNewEvents) {
+  std::vector<Event> log = dayLog(5000);
+  EventLogIndex index;
+  std::vector<Event> growing;
+  for (const Event &event : log) {
+    growing.push_back(event);
+    index.catchUp(growing);
+  }
+  expectMatchesScan(index, log);
+}
+
+TEST(EventLogIndexTest, SerializedIndexAnswersTheSame) {
+  std::vector<Event> log = dayLog(20000);
+  EventLogIndex index;
+  index.catchUp(log);
+  std::string data = index.serialize();
+
+  EventLogIndex loaded;
+  ASSERT_FALSE(loaded.deserialize(data).has_value());
+  expectMatchesScan(loaded, log);
+  EXPECT_EQ(loaded.serialize(), data);
+
+  for (std::size_t cut = 0; cut < data.size(); cut += 7) {
+    EXPECT_TRUE(loaded.deserialize(data.substr(0, cut)).has_value());
+  }
+  EXPECT_EQ(loaded.size(), 0u);
+}
+
+TEST(EventLogIndexTest, EventsAfterClosingTimeAreFound) {
+  // 23:00 is accepted after the 22:00 close, the end of day goes back
+  std::istringstream input("2\n09:00 22:00\n10\n09:10 1 bob\n09:11 2 bob 1\n"
+                           "21:00 1 carol\n21:30 1 alice\n23:00 4 alice\n");
+  std::optional<std::vector<Event>> log = collectEventLog(input);
+  ASSERT_TRUE(log.has_value());
+  EventLogIndex index;
+  index.catchUp(log.value());
+  expectMatchesScan(index, log.value());
+  EXPECT_EQ(index.timeRange(Time(22, 0), Time(22, 0)),
+            (EventLogIndex::Postings{5, 6}));
+  EXPECT_EQ(index.timeRange(Time(9, 0), Time(22, 30)),
+            (EventLogIndex::Postings{0, 1, 2, 3, 5, 6}));
+
+  EventLogIndex loaded;
+  ASSERT_FALSE(loaded.deserialize(index.serialize()).has_value());
+  expectMatchesScan(loaded, log.value());
+}
+
+TEST(EventLogIndexTest, ArchiveReadsIndexedPositions) {
+  std::vector<Event> log = dayLog(20000);
+  EventLogIndex index;
+  index.catchUp(log);
+  std::string image = event_archive::writeArchive(log, 128);
+  event_archive::Reader reader;
+  ASSERT_FALSE(reader.open(image).has_value());
+
+  const EventLogIndex::Postings &positions = index.clientEvents("client7");
+  ASSERT_FALSE(positions.empty());
+  std::vector<Event> events;
+  ASSERT_FALSE(reader.readEvents(positions, events).has_value());
+  ASSERT_EQ(events.size(), positions.size());
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    EXPECT_EQ(events[i].toString(), log[positions[i]].toString());
+  }
+  EXPECT_TRUE(reader.readEvents({static_cast<std::uint32_t>(log.size())},
+                                events)
+                  .has_value());
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "club_runner.h"
+#include "gtest/gtest.h"
+
+// Helpers shared by the test files.
+namespace test_helpers {
+
+// report of a plain text run with default options
+inline std::string runText(const std::string &text) {
+  std::istringstream in(text);
+  std::ostringstream out;
+  runTextInput(in, out);
+  return out.str();
+}
+
+inline std::vector<std::string> splitLines(const std::string &text) {
+  std::vector<std::string> lines;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// path of a file with data under the gtest temporary directory
+inline std::string writeTempFile(const std::string &name,
+                                 const std::string &data) {
+  std::string path = ::testing::TempDir() + name;
+  std::ofstream file(path, std::ios::binary);
+  file << data;
+  return path;
+}
+
+} // namespace test_helpers
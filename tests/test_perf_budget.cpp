@@ -0,0 +1,116 @@
+#include "club_runner.h"
+#include "reference_club.h"
+#include "workload.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+
+// Per-workload ns/event budgets of the whole text run, parsing included.
+// The ratio to the reference engine holds in every build type; absolute
+// budgets are checked only in optimized builds. CLUB_PERF_BUDGET_SCALE
+// multiplies both, for slow or loaded machines.
+
+namespace {
+
+struct Budget {
+  const char *name;
+  workload::Spec spec;
+  // ns/event of runTextInput, optimized builds only
+  double max_ns_per_event;
+  // runTextInput time over reference::runTextInput time, a little above 1
+  // for timing noise
+  double max_reference_ratio;
+};
+
+constexpr int kRepetitions = 3;
+
+double budgetScale() {
+  const char *value = std::getenv("CLUB_PERF_BUDGET_SCALE");
+  double scale = value == nullptr ? 1.0 : std::atof(value);
+  return scale > 0 ? scale : 1.0;
+}
+
+template <typename Run>
+double nsPerEvent(const std::string &text, std::size_t events, Run run) {
+  std::istringstream in(text);
+  std::ostringstream out;
+  auto start = std::chrono::steady_clock::now();
+  run(in, out);
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / static_cast<double>(events);
+}
+
+struct Timing {
+  // best of kRepetitions, the least disturbed run
+  double optimized;
+  double reference;
+  // best optimized/reference ratio of one repetition; both runs of a pair
+  // follow each other, so they see the same machine load
+  double ratio;
+};
+
+// the two engines alternate, and so does which of them runs first
+Timing measure(const std::string &text, std::size_t events) {
+  auto optimized_run = [](std::istream &in, std::ostream &out) {
+    runTextInput(in, out);
+  };
+  auto reference_run = [](std::istream &in, std::ostream &out) {
+    reference::runTextInput(in, out);
+  };
+  constexpr double kUnset = std::numeric_limits<double>::infinity();
+  Timing timing{kUnset, kUnset, kUnset};
+  for (int i = 0; i < kRepetitions; ++i) {
+    double optimized;
+    double reference;
+    if (i % 2 == 0) {
+      optimized = nsPerEvent(text, events, optimized_run);
+      reference = nsPerEvent(text, events, reference_run);
+    } else {
+      reference = nsPerEvent(text, events, reference_run);
+      optimized = nsPerEvent(text, events, optimized_run);
+    }
+    timing.optimized = std::min(timing.optimized, optimized);
+    timing.reference = std::min(timing.reference, reference);
+    timing.ratio = std::min(timing.ratio, optimized / reference);
+  }
+  return timing;
+}
+
+void checkBudget(const Budget &budget) {
+  SCOPED_TRACE(budget.name);
+  const std::string text = workload::generate(budget.spec);
+  Timing timing = measure(text, budget.spec.num_events);
+  ::testing::Test::RecordProperty("ns_per_event",
+                                  std::to_string(timing.optimized));
+  ::testing::Test::RecordProperty("reference_ns_per_event",
+                                  std::to_string(timing.reference));
+
+  const double scale = budgetScale();
+  EXPECT_LE(timing.ratio, budget.max_reference_ratio * scale)
+      << timing.optimized << " ns/event, reference " << timing.reference;
+#ifdef NDEBUG
+  EXPECT_LE(timing.optimized, budget.max_ns_per_event * scale)
+      << timing.optimized << " ns/event";
+#endif
+}
+
+} // namespace
+
+TEST(PerfBudgetTest, SmallClub) {
+  checkBudget({"small_club", {16, 64, 50000, 42}, 6000, 1.1});
+}
+
+TEST(PerfBudgetTest, QueueBound) {
+  // three tables for hundreds of clients, the queue is always full
+  checkBudget({"queue_bound", {3, 400, 50000, 7}, 7000, 1.1});
+}
+
+TEST(PerfBudgetTest, LargeClub) {
+  checkBudget({"large_club", {5000, 20000, 50000, 11}, 7000, 1.1});
+}
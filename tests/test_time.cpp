@@ -1,6 +1,8 @@
 #include "computer_club.h"
 #include "gtest/gtest.h"
 
+#include <utility>
+
 TEST(TimeTest, ParseValidTime) {
   Time t = Time::parse("08:05");
   ASSERT_EQ(t.hours, 8);
@@ -76,4 +78,45 @@ TEST(TimeTest, MinutesUntil) {
   Time end_time = Time::parse("10:30");
   ASSERT_EQ(start_time.minutesUntil(end_time), 90);
   ASSERT_EQ(end_time.minutesUntil(start_time), -90);
-}
\ No newline at end of file
+}
+
+TEST(TimeTest, TryParseReportsStatus) {
+  Time t(1, 1);
+  ASSERT_EQ(Time::tryParse("08:05", t), TimeParseStatus::OK);
+  ASSERT_EQ(t.toString(), "08:05");
+
+  Time untouched(7, 7);
+  ASSERT_EQ(Time::tryParse("8:05", untouched), TimeParseStatus::INVALID_FORMAT);
+  ASSERT_EQ(Time::tryParse("0805", untouched), TimeParseStatus::INVALID_FORMAT);
+  ASSERT_EQ(Time::tryParse("aa:bb", untouched), TimeParseStatus::NOT_A_NUMBER);
+  ASSERT_EQ(Time::tryParse("24:00", untouched), TimeParseStatus::INVALID_VALUE);
+  ASSERT_EQ(Time::tryParse("-1:00", untouched), TimeParseStatus::INVALID_VALUE);
+  ASSERT_EQ(untouched.toString(), "07:07");
+}
+
+TEST(TimeTest, TryParseKeepsStoiQuirks) {
+  // each part is read like std::stoi: leading whitespace and a sign are
+  // skipped, trailing characters are ignored
+  const std::pair<const char *, const char *> accepted[] = {
+      {"+9:05", "09:05"}, {"1a:2b", "01:02"}, {"09:+5", "09:05"},
+      {"9 :00", "09:00"}, {" 9:05", "09:05"}, {"-0:00", "00:00"}};
+  for (auto [input, expected] : accepted) {
+    Time t;
+    ASSERT_EQ(Time::tryParse(input, t), TimeParseStatus::OK) << input;
+    ASSERT_EQ(t.toString(), expected) << input;
+    ASSERT_EQ(Time::parse(input).toString(), expected) << input;
+  }
+
+  Time t;
+  ASSERT_EQ(Time::tryParse("--:00", t), TimeParseStatus::NOT_A_NUMBER);
+  ASSERT_EQ(Time::tryParse("12:-5", t), TimeParseStatus::INVALID_VALUE);
+  ASSERT_EQ(Time::tryParse("00:60", t), TimeParseStatus::INVALID_VALUE);
+  ASSERT_EQ(Time::tryParse("9:5 ", t), TimeParseStatus::INVALID_FORMAT);
+  EXPECT_THROW(Time::parse("--:00"), std::runtime_error);
+  EXPECT_THROW(Time::parse("12:-5"), std::runtime_error);
+
+  // >> skips the leading space, and the time field "9:05" then fails the
+  // five-character check
+  ASSERT_FALSE(parseEventInput(" 9:05 1 client1", 1).has_value());
+  ASSERT_TRUE(parseEventInput("09:05 1 client1", 1).has_value());
+}
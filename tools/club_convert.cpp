@@ -0,0 +1,58 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "binary_format.h"
+#include "event_archive.h"
+
+int main(int argc, char *argv[]) {
+  if (argc != 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <to-bin|to-text|archive-log|extract-log> <input_file>"
+                 " <output_file>"
+              << std::endl;
+    return 1;
+  }
+
+  std::string mode = argv[1];
+  // archive-log runs a text input and stores its event log,
+  // extract-log prints an archived event log as text
+  bool binary_input = mode == "to-text" || mode == "extract-log";
+  bool binary_output = mode == "to-bin" || mode == "archive-log";
+  if (!binary_input && !binary_output) {
+    std::cerr << "Error: unknown mode " << mode << std::endl;
+    return 1;
+  }
+
+  std::ios::openmode input_mode =
+      binary_input ? std::ios::in | std::ios::binary : std::ios::in;
+  std::ios::openmode output_mode =
+      binary_output ? std::ios::out | std::ios::binary : std::ios::out;
+
+  std::ifstream input_file(argv[2], input_mode);
+  if (!input_file.is_open()) {
+    std::cerr << "Error: Could not open file " << argv[2] << std::endl;
+    return 1;
+  }
+  std::ofstream output_file(argv[3], output_mode);
+  if (!output_file.is_open()) {
+    std::cerr << "Error: Could not create file " << argv[3] << std::endl;
+    return 1;
+  }
+
+  std::optional<std::string> error;
+  if (mode == "to-bin") {
+    error = binary_format::convertTextToBinary(input_file, output_file);
+  } else if (mode == "to-text") {
+    error = binary_format::convertBinaryToText(input_file, output_file);
+  } else if (mode == "archive-log") {
+    error = event_archive::archiveDayLog(input_file, output_file);
+  } else {
+    error = event_archive::decompressToText(input_file, output_file);
+  }
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+  return 0;
+}
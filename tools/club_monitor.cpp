@@ -0,0 +1,64 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "club_metrics.h"
+
+// Prints the live metrics of a task run started with --metrics-shm.
+int main(int argc, char *argv[]) {
+  if (argc != 2 && argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " </name> [interval_ms]" << std::endl;
+    return 1;
+  }
+  int interval_ms = 1000;
+  if (argc == 3) {
+    interval_ms = utils::parsePositiveInteger(argv[2]);
+    if (interval_ms <= 0) {
+      std::cerr << "Error: invalid interval " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+
+  SharedMetricsRegion region;
+  std::optional<std::string> error = region.open(argv[1]);
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+
+  // the rate is measured over one interval with the reader's own clock
+  MetricsSnapshot first, second;
+  // false for a foreign block or one a writer left in the middle of an
+  // update
+  if (!readMetrics(*region.block(), first)) {
+    std::cerr << "Error: unsupported or inconsistent metrics block"
+              << std::endl;
+    return 1;
+  }
+  std::uint64_t first_ns = steadyClockNs();
+  std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+  if (!readMetrics(*region.block(), second)) {
+    std::cerr << "Error: inconsistent metrics block" << std::endl;
+    return 1;
+  }
+  double seconds = (steadyClockNs() - first_ns) / 1e9;
+
+  std::cout << "events " << second.events_processed << '\n'
+            << "events_per_sec "
+            << static_cast<std::uint64_t>(
+                   (second.events_processed - first.events_processed) /
+                   seconds)
+            << '\n'
+            << "tables " << second.occupied_tables << '/'
+            << second.num_tables << '\n'
+            << "queue " << second.queue_length << '\n'
+            << "clients_inside " << second.clients_inside << '\n'
+            << "revenue " << second.revenue << '\n'
+            << "last_event "
+            << Time(static_cast<int>(second.last_event_minutes)).toString()
+            << '\n'
+            << "finished " << (second.day_finished ? "yes" : "no")
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "club_runner.h"
+#include "event_archive.h"
+#include "event_index.h"
+
+namespace {
+
+bool readFile(const std::string &path, std::string &data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Error: Could not open file " << path << std::endl;
+    return false;
+  }
+  data.assign(std::istreambuf_iterator<char>(file),
+              std::istreambuf_iterator<char>());
+  return true;
+}
+
+bool writeFile(const std::string &path, const std::string &data) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(data.data(), data.size());
+  if (!file) {
+    std::cerr << "Error: Could not write file " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int buildIndex(const std::string &input_path, const std::string &archive_path,
+               const std::string &index_path) {
+  std::ifstream input_file(input_path);
+  if (!input_file.is_open()) {
+    std::cerr << "Error: Could not open file " << input_path << std::endl;
+    return 1;
+  }
+  std::optional<std::vector<Event>> event_log = collectEventLog(input_file);
+  if (!event_log.has_value()) {
+    std::cerr << "Error: input has a rejected configuration or event line"
+              << std::endl;
+    return 1;
+  }
+  EventLogIndex index;
+  index.catchUp(event_log.value());
+  return writeFile(archive_path, event_archive::writeArchive(*event_log)) &&
+                 writeFile(index_path, index.serialize())
+             ? 0
+             : 1;
+}
+
+int runQuery(const std::string &archive_path, const std::string &index_path,
+             const std::string &kind, const std::vector<std::string> &args) {
+  std::string archive_data, index_data;
+  if (!readFile(archive_path, archive_data) ||
+      !readFile(index_path, index_data)) {
+    return 1;
+  }
+  event_archive::Reader archive;
+  EventLogIndex index;
+  std::optional<std::string> error = archive.open(archive_data);
+  if (!error.has_value()) {
+    error = index.deserialize(index_data);
+  }
+  if (!error.has_value() && index.size() != archive.size()) {
+    error = "index does not belong to the archive";
+  }
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+
+  std::vector<std::uint32_t> positions;
+  Time from, to;
+  if (kind == "client" && args.size() == 1) {
+    positions = index.clientEvents(args[0]);
+  } else if (kind == "table" && args.size() == 1 &&
+             utils::parsePositiveInteger(args[0]) > 0) {
+    positions = index.tableEvents(utils::parsePositiveInteger(args[0]));
+  } else if (kind == "time" && args.size() == 2 &&
+             Time::tryParse(args[0], from) == TimeParseStatus::OK &&
+             Time::tryParse(args[1], to) == TimeParseStatus::OK) {
+    positions = index.timeRange(from, to);
+  } else {
+    std::cerr << "Error: invalid query" << std::endl;
+    return 1;
+  }
+
+  std::vector<Event> events;
+  error = archive.readEvents(positions, events);
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+  for (const Event &event : events) {
+    std::cout << event.toString() << '\n';
+  }
+  std::cout.flush();
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc == 5 && std::string(argv[1]) == "index") {
+    return buildIndex(argv[2], argv[3], argv[4]);
+  }
+  if (argc >= 5) {
+    return runQuery(argv[1], argv[2], argv[3],
+                    std::vector<std::string>(argv + 4, argv + argc));
+  }
+  std::cerr << "Usage: " << argv[0]
+            << " index <input_file> <log_archive> <index_file>\n"
+            << "       " << argv[0]
+            << " <log_archive> <index_file> client <name>\n"
+            << "       " << argv[0]
+            << " <log_archive> <index_file> table <id>\n"
+            << "       " << argv[0]
+            << " <log_archive> <index_file> time <HH:MM> <HH:MM>" << std::endl;
+  return 1;
+}
@@ -0,0 +1,97 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "club_replay.h"
+
+namespace {
+
+int buildIndex(const std::string &input_path, const std::string &index_path,
+               std::size_t events_per_checkpoint) {
+  std::ifstream input_file(input_path, std::ios::binary);
+  if (!input_file.is_open()) {
+    std::cerr << "Error: Could not open file " << input_path << std::endl;
+    return 1;
+  }
+  ReplayIndex index;
+  std::optional<std::string> error =
+      index.build(input_file, events_per_checkpoint);
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+  std::string data = index.serialize();
+  std::ofstream index_file(index_path, std::ios::binary);
+  index_file.write(data.data(), data.size());
+  if (!index_file) {
+    std::cerr << "Error: Could not write file " << index_path << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int printState(const std::string &input_path, const std::string &index_path,
+               const Time &time) {
+  std::ifstream input_file(input_path, std::ios::binary);
+  std::ifstream index_file(index_path, std::ios::binary);
+  if (!input_file.is_open() || !index_file.is_open()) {
+    std::cerr << "Error: Could not open input or index file" << std::endl;
+    return 1;
+  }
+  std::string data((std::istreambuf_iterator<char>(index_file)),
+                   std::istreambuf_iterator<char>());
+  ReplayIndex index;
+  ClubStateSnapshot state;
+  std::optional<std::string> error = index.deserialize(data);
+  if (!error.has_value()) {
+    error = index.stateAt(input_file, time, state);
+  }
+  if (error.has_value()) {
+    std::cerr << "Error: " << error.value() << std::endl;
+    return 1;
+  }
+
+  std::cout << time.toString() << '\n';
+  for (const ClubStateSnapshot::TableState &table : state.tables) {
+    if (!table.client_name.empty()) {
+      std::cout << "table " << table.table_id << ' ' << table.client_name
+                << ' ' << table.session_start.toString() << '\n';
+    }
+  }
+  for (const std::string &client_name : state.waiting_queue) {
+    std::cout << "queue " << client_name << '\n';
+  }
+  std::cout.flush();
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string mode = argc > 1 ? argv[1] : "";
+  if (mode == "index" && (argc == 4 || argc == 5)) {
+    std::size_t events_per_checkpoint =
+        ReplayIndex::kDefaultEventsPerCheckpoint;
+    if (argc == 5) {
+      int value = utils::parsePositiveInteger(argv[4]);
+      if (value <= 0) {
+        std::cerr << "Error: invalid checkpoint interval " << argv[4]
+                  << std::endl;
+        return 1;
+      }
+      events_per_checkpoint = static_cast<std::size_t>(value);
+    }
+    return buildIndex(argv[2], argv[3], events_per_checkpoint);
+  }
+  Time time;
+  if (mode == "state" && argc == 5 &&
+      Time::tryParse(argv[4], time) == TimeParseStatus::OK) {
+    return printState(argv[2], argv[3], time);
+  }
+  std::cerr << "Usage: " << argv[0]
+            << " index <input_file> <index_file> [events_per_checkpoint]\n"
+            << "       " << argv[0]
+            << " state <input_file> <index_file> <HH:MM>" << std::endl;
+  return 1;
+}